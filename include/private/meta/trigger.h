@@ -42,6 +42,8 @@ namespace lsp
             static constexpr float SAMPLE_LENGTH_MAX        = 64000.0f; // Maximum sample length (ms)
             static constexpr float SAMPLE_LENGTH_DFL        = 0.0f;     // Sample length (ms)
             static constexpr float SAMPLE_LENGTH_STEP       = 0.1f;     // Sample step (ms)
+            static constexpr float SAMPLE_DRAFT_LENGTH_MIN  = 1000.0f;  // Minimum length of the sample to render draft while editing (ms)
+            static constexpr float SAMPLE_DRAFT_SETTLE      = 250.0f;   // Time after the last edit to replace the draft render (ms)
 
             static constexpr float PREDELAY_MIN             = 0.0f;     // Pre-delay min (ms)
             static constexpr float PREDELAY_MAX             = 100.0f;   // Pre-delay max (ms)
@@ -53,7 +55,14 @@ namespace lsp
             static constexpr size_t SAMPLE_FILES            = 8;        // Number of sample files per trigger
             static constexpr size_t BUFFER_SIZE             = 4096;     // Size of temporary buffer
             static constexpr size_t PLAYBACKS_MAX           = 8192;     // Maximum number of simultaneously playing samples
+            static constexpr size_t AA_LOBES                = 4;        // Number of lobes of the anti-aliasing kernel for pitched voices
+            static constexpr size_t AA_RESOLUTION           = 256;      // Number of points of the anti-aliasing kernel table per lobe
             static constexpr float ACTIVITY_LIGHTING        = 0.1f;     // Activity lighting (seconds)
+            static constexpr size_t GC_BATCH_SIZE           = 8;        // Number of retired samples to start garbage collection
+            static constexpr size_t GC_BATCH_BYTES          = 0x1000000;// Size of retired sample data to start garbage collection (bytes)
+            static constexpr float GC_PERIOD                = 500.0f;   // Maximum time to hold retired samples (ms)
+            static constexpr size_t SAMPLE_CACHE_SIZE       = 0x20000000;   // Maximum size of the rendered sample cache (bytes)
+            static constexpr size_t LOAD_DEFER_RENDERS      = 4;        // Maximum number of renders submitted ahead of the waiting file load
 
             static constexpr float  DETECT_LEVEL_DFL        = GAIN_AMP_M_12_DB;     // Default detection level [G]
 
@@ -92,8 +101,37 @@ namespace lsp
             static constexpr float  MIDINOTE_DFL            = 0.0f;     // MIDI note meter default value
             static constexpr float  MIDINOTE_STEP           = 1.0f;     // MIDI note meter step
 
+            static constexpr float  IDLE_LEVEL              = GAIN_AMP_M_80_DB;     // Input level below which the trigger may fall asleep [G]
+            static constexpr float  IDLE_HOLD_TIME          = 500.0f;   // Time of silence before the trigger falls asleep [ms]
+
             static constexpr float  HISTORY_TIME            = 5.0f;     // Amount of time to display history [s]
             static constexpr size_t HISTORY_MESH_SIZE       = 640;      // 640 dots for history
+            static constexpr size_t HISTORY_ZOOM_LEVELS     = 7;        // Number of history zoom levels, each next level doubles the time window
+            static constexpr size_t HISTORY_ZOOM_DFL        = 3;        // Default zoom level which matches HISTORY_TIME
+            static constexpr float  IDISPLAY_TIMEOUT        = 2.0f;     // Time without redraws after which the inline display is considered hidden [s]
+            static constexpr float  CALIBRATION_RATE        = 10.0f;    // Refresh rate of calibrated thresholds [Hz]
+            static constexpr size_t EVENT_LOG_SIZE          = 256;      // Size of the trigger event log, should be power of 2
+
+            static constexpr size_t MIDI_RECORD_MAX         = 0x10000;  // Maximum number of recorded MIDI events
+            static constexpr size_t SMF_DIVISION            = 960;      // Number of ticks per quarter note in exported MIDI files
+            static constexpr size_t SMF_TEMPO               = 500000;   // Tempo of exported MIDI files, microseconds per quarter note
+
+            static constexpr float  CAL_WINDOW              = 10.0f;    // Window for measuring the trigger function maximums [ms]
+            static constexpr float  CAL_LEVEL_MIN           = 1e-6f;    // Minimum level accounted by calibration [G]
+            static constexpr float  CAL_DB_MIN              = -120.0f;  // Minimum level of the calibration histogram [dB]
+            static constexpr float  CAL_DB_STEP             = 0.5f;     // Step of the calibration histogram [dB]
+            static constexpr size_t CAL_BINS                = 300;      // Number of bins in the calibration histogram
+            static constexpr size_t CAL_HITS_MIN            = 8;        // Minimum number of hits required for calibration
+            static constexpr float  CAL_NOISE_PERCENTILE    = 0.2f;     // Percentile of window maximums that estimates the noise floor
+            static constexpr float  CAL_RANGE_PERCENTILE    = 0.05f;    // Percentile of hit levels that estimates the dynamics range
+            static constexpr float  CAL_HIT_MARGIN          = 12.0f;    // Minimum level of hits above the noise floor [dB]
+            static constexpr float  CAL_DETECT_MARGIN       = 6.0f;     // Minimum detect level above the noise floor [dB]
+            static constexpr float  CAL_RELEASE_MARGIN      = 3.0f;     // Release level above the noise floor [dB]
+
+            static constexpr float  DSP_LOAD_MIN            = 0.0f;     // Minimum DSP load of the processing stage [%]
+            static constexpr float  DSP_LOAD_MAX            = 100.0f;   // Maximum DSP load of the processing stage [%]
+            static constexpr float  DSP_LOAD_DFL            = 0.0f;     // Default DSP load of the processing stage [%]
+            static constexpr float  DSP_LOAD_STEP           = 0.01f;    // DSP load step [%]
 
             static constexpr float  HPF_MIN                 = 10.0f;
             static constexpr float  HPF_MAX                 = 20000.0f;
@@ -110,6 +148,27 @@ namespace lsp
             static constexpr float DRIFT_STEP               = 0.1f;     // Delay step
             static constexpr float DRIFT_MAX                = 100.0f;   // Maximum delay
 
+            static constexpr float QUEUE_DEPTH_MIN          = 0.0f;     // Minimum number of background tasks
+            static constexpr float QUEUE_DEPTH_MAX          = SAMPLE_FILES * 2 + 1;   // Maximum number of background tasks
+            static constexpr float QUEUE_DEPTH_DFL          = 0.0f;     // Default number of background tasks
+            static constexpr float QUEUE_DEPTH_STEP         = 1.0f;     // Step of number of background tasks
+
+            static constexpr float KIT_PROGRESS_MIN         = 0.0f;     // Minimum kit loading progress (%)
+            static constexpr float KIT_PROGRESS_MAX         = 100.0f;   // Maximum kit loading progress (%)
+            static constexpr float KIT_PROGRESS_DFL         = 0.0f;     // Default kit loading progress (%)
+            static constexpr float KIT_PROGRESS_STEP        = 0.1f;     // Step of kit loading progress (%)
+            static constexpr size_t KIT_THREADS_MAX         = 8;        // Maximum number of threads to load the kit
+
+            static constexpr float PITCH_VAR_MIN            = 0.0f;     // Minimum pitch variation (st)
+            static constexpr float PITCH_VAR_DFL            = 0.0f;     // Default pitch variation (st)
+            static constexpr float PITCH_VAR_STEP           = 0.01f;    // Pitch variation step (st)
+            static constexpr float PITCH_VAR_MAX            = 1.0f;     // Maximum pitch variation (st)
+
+            static constexpr float IDISPLAY_RATE_MIN        = 1.0f;     // Minimum refresh rate of the inline display (Hz)
+            static constexpr float IDISPLAY_RATE_MAX        = 60.0f;    // Maximum refresh rate of the inline display (Hz)
+            static constexpr float IDISPLAY_RATE_DFL        = 25.0f;    // Default refresh rate of the inline display (Hz)
+            static constexpr float IDISPLAY_RATE_STEP       = 1.0f;     // Refresh rate step of the inline display (Hz)
+
             static constexpr float DYNA_MIN                 = 0.0f;     // Minimum dynamics
             static constexpr float DYNA_DFL                 = 0.0f;     // Default dynamics
             static constexpr float DYNA_STEP                = 0.05f;    // Dynamics step
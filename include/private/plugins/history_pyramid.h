@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_HISTORY_PYRAMID_H_
+#define PRIVATE_PLUGINS_HISTORY_PYRAMID_H_
+
+#include <lsp-plug.in/plug-fw/plug.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Multi-resolution history of the signal envelope. Each level is a ring buffer
+         * of the same size, each dot of the next level is a maximum of two dots of the
+         * previous level, so each next level covers twice longer period of time.
+         */
+        class HistoryPyramid
+        {
+            protected:
+                typedef struct level_t
+                {
+                    float              *vRing;          // Ring buffer with dots
+                    size_t              nHead;          // Position of the next dot in the ring buffer
+                    size_t              nDots;          // Overall number of dots added to the level
+                    float               fPending;       // Pending dot for the next level
+                    bool                bPending;       // Pending dot is present
+                } level_t;
+
+            protected:
+                level_t            *vLevels;            // List of levels
+                size_t              nLevels;            // Number of levels
+                size_t              nSize;              // Number of dots per level
+                uint8_t            *pData;              // Allocated data
+
+            public:
+                explicit HistoryPyramid();
+                HistoryPyramid(const HistoryPyramid &) = delete;
+                HistoryPyramid(HistoryPyramid &&) = delete;
+                ~HistoryPyramid();
+
+                HistoryPyramid & operator = (const HistoryPyramid &) = delete;
+                HistoryPyramid & operator = (HistoryPyramid &&) = delete;
+
+                void                construct();
+                void                destroy();
+
+            public:
+                /** Initialize the history
+                 *
+                 * @param levels number of levels
+                 * @param size number of dots per level
+                 * @return true on success
+                 */
+                bool                init(size_t levels, size_t size);
+
+                /** Get number of levels
+                 *
+                 * @return number of levels
+                 */
+                inline size_t       levels() const      { return nLevels;   }
+
+                /** Get number of dots per level
+                 *
+                 * @return number of dots per level
+                 */
+                inline size_t       size() const        { return nSize;     }
+
+                /** Get overall number of dots added to the level, the value is not reset by clear()
+                 *
+                 * @param level level index
+                 * @return overall number of dots added to the level
+                 */
+                inline size_t       dots(size_t level) const    { return vLevels[level].nDots; }
+
+                /** Add dot to the first level, propagate maximums to the next levels
+                 *
+                 * @param value value of the dot
+                 */
+                void                process(float value);
+
+                /** Read the most recent dots of the level in chronological order
+                 *
+                 * @param level level index
+                 * @param dst destination buffer
+                 * @param count number of dots to read, should not be greater than size()
+                 */
+                void                read(size_t level, float *dst, size_t count) const;
+
+                /** Clear all levels
+                 *
+                 */
+                void                clear();
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_HISTORY_PYRAMID_H_ */
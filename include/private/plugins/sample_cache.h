@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_SAMPLE_CACHE_H_
+#define PRIVATE_PLUGINS_SAMPLE_CACHE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <lsp-plug.in/io/Path.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * On-disk cache of rendered samples and their thumbnails. Each entry is stored in a separate
+         * file named by the hash of the key: the source file identity, render parameters and sample rate.
+         * Sample data is stored as raw channel arrays and read directly into the sample buffer.
+         * Keys are hashed and compared as raw memory, so they should be zeroed before they are filled.
+         * The overall size of the cache is limited: least recently used entries are removed first,
+         * the modification time of the entry is updated each time the entry is loaded.
+         */
+        class SampleCache
+        {
+            public:
+                typedef struct key_t
+                {
+                    uint64_t            nSource;            // Hash of the source file: path, size and modification time
+                    uint32_t            nChannels;          // Number of channels
+                    uint32_t            nSampleRate;        // Sample rate
+                    uint32_t            nThumbs;            // Number of thumbnail dots per channel
+                    float               fHeadCut;           // Head cut (ms)
+                    float               fTailCut;           // Tail cut (ms)
+                    float               fFadeIn;            // Fade in (ms)
+                    float               fFadeOut;           // Fade out (ms)
+                    uint32_t            nReverse;           // Reverse flag
+                    uint32_t            nReserved;          // Reserved, should be zero
+                    uint32_t            nPadding;           // Explicit padding, should be zero
+                } key_t;
+
+            protected:
+                typedef struct header_t
+                {
+                    uint8_t             vSignature[4];      // File signature
+                    uint32_t            nVersion;           // File format version
+                    key_t               sKey;               // Key of the entry
+                    uint32_t            nChannels;          // Number of stored channels
+                    uint32_t            nLength;            // Length of each channel in samples
+                } header_t;
+
+                typedef struct entry_t
+                {
+                    char                sName[32];          // File name of the entry
+                    wsize_t             nSize;              // Size of the entry
+                    wssize_t            nTime;              // Time of the last use
+                } entry_t;
+
+            protected:
+                io::Path            sDirectory;             // Cache directory
+                wsize_t             nLimit;                 // Maximum overall size of cache entries
+                bool                bEnabled;               // Cache is enabled
+
+            protected:
+                static uint64_t     hash(uint64_t seed, const void *data, size_t size);
+                static int          compare_entries(const void *a, const void *b);
+                status_t            entry_path(io::Path *path, const key_t *key) const;
+                void                touch(const io::Path *path) const;
+                status_t            trim() const;
+
+            public:
+                explicit SampleCache();
+                SampleCache(const SampleCache &) = delete;
+                SampleCache(SampleCache &&) = delete;
+                ~SampleCache();
+
+                SampleCache & operator = (const SampleCache &) = delete;
+                SampleCache & operator = (SampleCache &&) = delete;
+
+            public:
+                /** Initialize cache in the sub-directory of the temporary directory
+                 *
+                 * @param name name of the sub-directory
+                 * @param limit maximum overall size of cache entries in bytes
+                 * @return status of operation
+                 */
+                status_t            init(const char *name, wsize_t limit);
+
+                /** Compute hash of the source file identity
+                 *
+                 * @param path path to the source file
+                 * @return hash of the source file or zero if the file can not be identified
+                 */
+                static uint64_t     source_hash(const char *path);
+
+                /** Load rendered sample and thumbnails from the cache
+                 *
+                 * @param key key of the entry
+                 * @param dst sample to store data
+                 * @param thumbs list of thumbnail buffers, one per channel
+                 * @return status of operation, STATUS_NOT_FOUND if there is no valid entry
+                 */
+                status_t            load(const key_t *key, dspu::Sample *dst, float * const *thumbs) const;
+
+                /** Store rendered sample and thumbnails to the cache, least recently used entries
+                 * are removed if the cache exceeds the size limit
+                 *
+                 * @param key key of the entry
+                 * @param src rendered sample
+                 * @param thumbs list of thumbnail buffers, one per channel
+                 * @return status of operation
+                 */
+                status_t            store(const key_t *key, const dspu::Sample *src, const float * const *thumbs) const;
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_SAMPLE_CACHE_H_ */
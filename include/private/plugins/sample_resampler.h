@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_SAMPLE_RESAMPLER_H_
+#define PRIVATE_PLUGINS_SAMPLE_RESAMPLER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Resampler of long samples: the source sample is split into chunks which are resampled
+         * in parallel by the threads of the worker pool. Each chunk is extended by overlapping margins
+         * which are cut off after resampling, chunk boundaries are aligned to the positions where
+         * source and destination sample grids match, so chunks are stitched without seams.
+         */
+        class SampleResampler
+        {
+            public:
+                enum quality_t
+                {
+                    Q_DRAFT,                                            // Linear interpolation, for interactive editing
+                    Q_HIGH                                              // Full quality resampling
+                };
+
+            protected:
+                static constexpr size_t THREADS_MAX         = 4;        // Maximum number of threads for one sample
+                static constexpr float  CHUNK_MIN           = 2.0f;     // Minimum length of the chunk (s)
+                static constexpr size_t MARGIN_MIN          = 256;      // Minimum overlap of chunks (samples of the slowest rate)
+
+                typedef struct chunk_t
+                {
+                    size_t              nFirst;                         // First source sample of the chunk
+                    size_t              nCount;                         // Number of source samples in the chunk
+                } chunk_t;
+
+                typedef struct job_t
+                {
+                    const dspu::Sample *pSrc;                           // Source sample
+                    dspu::Sample       *pDst;                           // Destination sample
+                    size_t              nSrcRate;                       // Source sample rate
+                    size_t              nDstRate;                       // Destination sample rate
+                    size_t              nMargin;                        // Overlap of chunks in source samples
+                    chunk_t            *vChunks;                        // List of chunks
+                    size_t              nChunks;                        // Number of chunks
+                    uatomic_t           nNext;                          // Next chunk to process
+                    uatomic_t           nStatus;                        // Overall status
+                } job_t;
+
+            protected:
+                static size_t       gcd(size_t a, size_t b);
+                static status_t     process_chunk(job_t *job, const chunk_t *chunk);
+                static void         worker(void *arg);
+                static status_t     resample_draft(dspu::Sample *dst, const dspu::Sample *src, size_t sample_rate);
+
+            public:
+                /** Resample the sample
+                 *
+                 * @param dst destination sample
+                 * @param src source sample
+                 * @param sample_rate target sample rate
+                 * @param quality resampling quality
+                 * @param threads maximum number of threads to use including the caller thread, 0 means no limit
+                 * @return status of operation
+                 */
+                static status_t     resample(dspu::Sample *dst, const dspu::Sample *src, size_t sample_rate, quality_t quality = Q_HIGH, size_t threads = 0);
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_SAMPLE_RESAMPLER_H_ */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_SMF_WRITER_H_
+#define PRIVATE_PLUGINS_SMF_WRITER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/OutFileStream.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Buffered writer of single-track Standard MIDI Files (format 0),
+         * does not perform any memory allocations while writing events
+         */
+        class SMFWriter
+        {
+            protected:
+                static constexpr size_t BUFFER_SIZE     = 0x1000;
+
+            protected:
+                io::OutFileStream   sOS;                        // Output stream
+                size_t              nOffset;                    // Number of bytes in the buffer
+                uint8_t             vBuffer[BUFFER_SIZE];       // Output buffer
+
+            protected:
+                status_t            flush();
+                status_t            put(const uint8_t *data, size_t count);
+                status_t            put_varlen(uint32_t value);
+
+            public:
+                explicit SMFWriter();
+                SMFWriter(const SMFWriter &) = delete;
+                SMFWriter(SMFWriter &&) = delete;
+                ~SMFWriter();
+
+                SMFWriter & operator = (const SMFWriter &) = delete;
+                SMFWriter & operator = (SMFWriter &&) = delete;
+
+            public:
+                /** Get size of the variable-length quantity
+                 *
+                 * @param value value to encode
+                 * @return number of bytes
+                 */
+                static size_t       varlen_size(uint32_t value);
+
+                /** Get size of the channel event
+                 *
+                 * @param delta delta time in ticks
+                 * @return size of the event in bytes
+                 */
+                static inline size_t event_size(uint32_t delta) { return varlen_size(delta) + 3; }
+
+                /** Get size of the track contents which contains only tempo event, end-of-track event
+                 * and no channel events
+                 *
+                 * @return size of the track
+                 */
+                static inline size_t empty_track_size()         { return 7 + 4; }
+
+            public:
+                /** Create file and write file header
+                 *
+                 * @param path path to the file
+                 * @param division number of ticks per quarter note
+                 * @return status of operation
+                 */
+                status_t            open(const char *path, uint16_t division);
+
+                /** Start track
+                 *
+                 * @param length length of the track contents in bytes
+                 * @param tempo tempo in microseconds per quarter note
+                 * @return status of operation
+                 */
+                status_t            begin_track(uint32_t length, uint32_t tempo);
+
+                /** Write channel event
+                 *
+                 * @param delta delta time in ticks
+                 * @param status status byte
+                 * @param data1 first data byte
+                 * @param data2 second data byte
+                 * @return status of operation
+                 */
+                status_t            write_event(uint32_t delta, uint8_t status, uint8_t data1, uint8_t data2);
+
+                /** End track
+                 *
+                 * @return status of operation
+                 */
+                status_t            end_track();
+
+                /** Flush all data and close the file
+                 *
+                 * @return status of operation
+                 */
+                status_t            close();
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_SMF_WRITER_H_ */
@@ -27,13 +27,16 @@
 #include <lsp-plug.in/dsp-units/ctl/Toggle.h>
 #include <lsp-plug.in/dsp-units/ctl/Bypass.h>
 #include <lsp-plug.in/dsp-units/ctl/Blink.h>
-#include <lsp-plug.in/dsp-units/util/MeterGraph.h>
 #include <lsp-plug.in/dsp-units/util/Sidechain.h>
 #include <lsp-plug.in/lltl/parray.h>
 #include <lsp-plug.in/ipc/ITask.h>
 
 #include <private/meta/trigger.h>
+#include <private/plugins/history_pyramid.h>
+#include <private/plugins/trigger_calibrator.h>
+#include <private/plugins/trigger_events.h>
 #include <private/plugins/trigger_kernel.h>
+#include <private/plugins/trigger_profiler.h>
 
 namespace lsp
 {
@@ -44,6 +47,35 @@ namespace lsp
          */
         class trigger: public plug::Module
         {
+            protected:
+                class MidiExporter: public ipc::ITask
+                {
+                    private:
+                        trigger                *pCore;
+
+                    public:
+                        explicit MidiExporter(trigger *core);
+                        virtual ~MidiExporter();
+
+                    public:
+                        virtual status_t        run();
+                        void                    dump(dspu::IStateDumper *v) const;
+                };
+
+                class MidiAllocator: public ipc::ITask
+                {
+                    private:
+                        trigger                *pCore;
+
+                    public:
+                        explicit MidiAllocator(trigger *core);
+                        virtual ~MidiAllocator();
+
+                    public:
+                        virtual status_t        run();
+                        void                    dump(dspu::IStateDumper *v) const;
+                };
+
             protected:
                 enum state_t
                 {
@@ -61,6 +93,13 @@ namespace lsp
                     S_RIGHT
                 };
 
+                enum graph_t
+                {
+                    G_INPUT,
+                    G_FUNCTION,
+                    G_VELOCITY
+                };
+
                 enum mode_t
                 {
                     M_PEAK,
@@ -69,16 +108,27 @@ namespace lsp
                     M_UNIFORM,
                 };
 
+                typedef struct midi_record_t
+                {
+                    wsize_t             nTime;          // Absolute position of the event in samples
+                    uint8_t             nStatus;        // Status byte
+                    uint8_t             nNote;          // Note number
+                    uint8_t             nVelocity;      // Note velocity
+                } midi_record_t;
+
                 typedef struct channel_t
                 {
                     dspu::Bypass        sBypass;        // Bypass
-                    dspu::MeterGraph    sGraph;         // Metering graph
+                    HistoryPyramid      sGraph;         // Metering graph
                     float              *vCtl;           // Control chain
+                    float               fDotLevel;      // Maximum level of the current history dot
+                    size_t              nGraphSync;     // Number of history dots at the moment of last graph transfer
                     bool                bVisible;       // Visibility flag
 
                     plug::IPort        *pIn;            // Input port
                     plug::IPort        *pOut;           // Output port
                     plug::IPort        *pGraph;         // Graph port
+                    plug::IPort        *pGraphDelta;    // Incremental graph port
                     plug::IPort        *pMeter;         // Metering port
                     plug::IPort        *pVisible;       // Visibility port
                 } channel_t;
@@ -96,12 +146,16 @@ namespace lsp
 
                 // Processors and buffers
                 trigger_kernel          sKernel;                // Output kernel
-                dspu::MeterGraph        sFunction;              // Function
-                dspu::MeterGraph        sVelocity;              // Trigger velocity level
+                HistoryPyramid          sFunction;              // Function
+                HistoryPyramid          sVelocity;              // Trigger velocity level
                 dspu::Blink             sActive;                // Activity blink
+                TriggerEventLog         sEvents;                // Log of trigger events
+                TriggerProfiler         sProfiler;              // Profiler of processing stages
+                TriggerCalibrator       sCalibrator;            // Calibrator of trigger thresholds
                 channel_t               vChannels[meta::trigger_metadata::TRACKS_MAX];  // Output channels
                 float                  *vTimePoints;            // Time points buffer
                 float                  *vIDisplay;              // Buffer for inline display
+                float                  *vIDCoords[meta::trigger_metadata::TRACKS_MAX + 2]; // Cached coordinates of history dots for inline display
 
                 // Processing variables
                 ssize_t                 nCounter;               // Counter for detect/release
@@ -109,6 +163,48 @@ namespace lsp
                 float                   fVelocity;              // Current velocity value
                 bool                    bFunctionActive;        // Function activity
                 bool                    bVelocityActive;        // Velocity activity
+                size_t                  nIdleCounter;           // Number of silent samples
+                size_t                  nIdleHold;              // Number of silent samples before falling asleep
+                float                   fIdleLevel;             // Input level considered as silence
+                size_t                  nDotSamples;            // Number of samples per history dot
+                size_t                  nDotLeft;               // Number of samples left for the current history dot
+                float                   fFunctionDot;           // Maximum function level of the current history dot
+                float                   fVelocityDot;           // Maximum velocity of the current history dot
+                bool                    bHistory;               // History graphs are being fed
+                bool                    bUIActive;              // UI is active
+                bool                    bIDisplay;              // Inline display is in use
+                bool                    bIDisplayDirty;         // Inline display needs to be redrawn
+                bool                    bIDisplayQuery;         // Inline display redraw has been requested but not performed yet
+                float                   fIDisplayRate;          // Refresh rate of the inline display
+                size_t                  nIDisplayCounter;       // Number of samples since last inline display redraw request
+                size_t                  nIDisplayPeriod;        // Minimum number of samples between inline display redraw requests
+                size_t                  nIDisplayWait;          // Number of samples since the first unanswered redraw request
+                size_t                  nIDisplayTimeout;       // Number of samples without redraws after which the inline display is hidden
+                size_t                  nHistoryDots;           // Overall number of history dots, changes on history reset
+                size_t                  nIDisplayDots;          // Number of history dots at the moment of the last inline display redraw
+                size_t                  nIDisplayHeight;        // Height of the inline display at the moment of the last redraw
+                size_t                  nFunctionSync;          // Number of history dots at the moment of last function transfer
+                size_t                  nVelocitySync;          // Number of history dots at the moment of last velocity transfer
+                size_t                  nZoom;                  // History zoom level
+                size_t                  nZoomDots;              // Number of dots of the history zoom level at the moment of last check
+                wsize_t                 nPosition;              // Absolute position of the current block in samples
+                size_t                  nChunkOffset;           // Offset of the currently processed chunk in the audio block
+
+                // MIDI recording and export
+                ipc::IExecutor         *pExecutor;              // Executor service
+                MidiExporter            sMidiExporter;          // MIDI file export task
+                MidiAllocator           sMidiAllocator;         // Allocation of the buffer for recorded MIDI events
+                midi_record_t          *vMidiRecords;           // Recorded MIDI events
+                midi_record_t          *vMidiAlloc;             // Buffer allocated by the allocation task
+                size_t                  nMidiRecords;           // Number of recorded MIDI events
+                size_t                  nMidiExport;            // Number of MIDI events to export
+                wsize_t                 nMidiOrigin;            // Absolute position of the recording start in samples
+                status_t                nMidiStatus;            // MIDI export status
+                bool                    bMidiRecord;            // MIDI recording is enabled
+                bool                    bMidiReset;             // MIDI recording should be restarted
+                bool                    bMidiOverflow;          // Recorded MIDI events did not fit into the buffer
+                bool                    bMidiTruncated;         // Exported MIDI events have been truncated
+                uatomic_t               nEventSync;             // Number of events at the moment of last event log transfer
 
                 // Parameters
                 size_t                  nNote;                  // Trigger note
@@ -118,6 +214,10 @@ namespace lsp
                 bool                    bPause;                 // Pause analysis refresh
                 bool                    bClear;                 // Clear analysis
                 bool                    bUISync;                // Synchronize with UI
+                bool                    bMeshSync;              // Transfer complete history meshes
+                bool                    bCalibrate;             // Calibration is in progress
+                size_t                  nCalibrationCounter;    // Number of samples since last output of calibrated thresholds
+                size_t                  nCalibrationPeriod;     // Number of samples between outputs of calibrated thresholds
 
                 size_t                  nDetectCounter;         // Detect counter
                 size_t                  nReleaseCounter;        // Release counter
@@ -132,12 +232,23 @@ namespace lsp
 
                 // Control ports
                 plug::IPort            *pFunction;              // Trigger function
+                plug::IPort            *pFunctionDelta;         // Incremental trigger function
                 plug::IPort            *pFunctionLevel;         // Function level
                 plug::IPort            *pFunctionActive;        // Function activity
                 plug::IPort            *pVelocity;              // Trigger velocity
+                plug::IPort            *pVelocityDelta;         // Incremental trigger velocity
                 plug::IPort            *pVelocityLevel;         // Trigger velocity level
                 plug::IPort            *pVelocityActive;        // Trigger velocity activity
                 plug::IPort            *pActive;                // Trigger activity flag
+                plug::IPort            *pEvents;                // Trigger event log
+                plug::IPort            *pProfiling;             // Profiling switch
+                plug::IPort            *pDspLoad[TriggerProfiler::ST_TOTAL];    // DSP load of processing stages
+                plug::IPort            *pCalibrate;             // Calibration switch
+                plug::IPort            *pCalDetectLevel;        // Calibrated detect level
+                plug::IPort            *pCalReleaseLevel;       // Calibrated relative release level
+                plug::IPort            *pCalDynaRange1;         // Calibrated dynamics range 1
+                plug::IPort            *pCalDynaRange2;         // Calibrated dynamics range 2
+                plug::IPort            *pIDisplayRate;          // Inline display refresh rate
 
                 plug::IPort            *pMidiIn;                // MIDI input port
                 plug::IPort            *pMidiOut;               // MIDI output port
@@ -145,6 +256,9 @@ namespace lsp
                 plug::IPort            *pNote;                  // Note port
                 plug::IPort            *pOctave;                // Octave port
                 plug::IPort            *pMidiNote;              // Output midi note #
+                plug::IPort            *pMidiRecord;            // Record MIDI events
+                plug::IPort            *pMidiExportFile;        // MIDI export file
+                plug::IPort            *pMidiExportStatus;      // MIDI export status
 
                 plug::IPort            *pBypass;                // Bypass port
                 plug::IPort            *pDry;                   // Dry output
@@ -153,6 +267,7 @@ namespace lsp
                 plug::IPort            *pGain;                  // Gain output
                 plug::IPort            *pPause;                 // Pause analysis
                 plug::IPort            *pClear;                 // Clear analysis
+                plug::IPort            *pZoom;                  // History zoom level
                 plug::IPort            *pPreamp;                // Pre-amplification
                 plug::IPort            *pScHpfMode;             // Sidechain high-pass filter mode
                 plug::IPort            *pScHpfFreq;             // Sidechain high-pass filter frequency
@@ -172,9 +287,24 @@ namespace lsp
                 plug::IPort            *pReleaseValue;          // Release value
 
             protected:
-                void                trigger_on(size_t timestamp, float level);
+                void                trigger_on(size_t timestamp, float level, float sc_level);
                 void                trigger_off(size_t timestamp, float level);
                 void                process_samples(const float *sc, size_t samples);
+                void                process_idle(float **outs, const float **ins, size_t samples);
+                float               measure_input(const float **ins, float *levels, float preamp, size_t samples);
+                void                update_history_state();
+                void                advance_history(size_t samples);
+                float               history_time() const;
+                void                update_time_points();
+                bool                fill_history_mesh(plug::IPort *port, const HistoryPyramid *graph, graph_t type);
+                void                sync_history_mesh(plug::IPort *port, const HistoryPyramid *graph, size_t *sync);
+                void                sync_event_log();
+                void                output_dsp_load(size_t samples);
+                void                output_calibration(size_t samples);
+                void                record_midi_event(size_t timestamp, uint8_t status, uint8_t velocity);
+                void                process_midi_export();
+                status_t            export_midi_file();
+                status_t            allocate_midi_records();
                 inline void         update_counters();
                 size_t              decode_mode();
                 size_t              decode_source();
@@ -191,6 +321,7 @@ namespace lsp
                 virtual void        update_settings() override;
                 virtual void        update_sample_rate(long sr) override;
                 virtual void        ui_activated() override;
+                virtual void        ui_deactivated() override;
 
                 virtual void        process(size_t samples) override;
                 virtual bool        inline_display(plug::ICanvas *cv, size_t width, size_t height) override;
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_TRIGGER_CALIBRATOR_H_
+#define PRIVATE_PLUGINS_TRIGGER_CALIBRATOR_H_
+
+#include <lsp-plug.in/plug-fw/plug.h>
+
+#include <private/meta/trigger.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Result of trigger calibration
+         */
+        typedef struct calibration_t
+        {
+            float               fDetectLevel;       // Detection level
+            float               fReleaseLevel;      // Release level relative to the detection level
+            float               fDynaTop;           // Top of the dynamics range
+            float               fDynaBottom;        // Bottom of the dynamics range
+        } calibration_t;
+
+        /**
+         * Collects statistics of the trigger function: distribution of the short-time
+         * maximums gives the noise floor, distribution of local peaks gives the levels
+         * of hits. The statistics is used to estimate the trigger thresholds.
+         */
+        class TriggerCalibrator
+        {
+            protected:
+                uint32_t            vWindows[meta::trigger_metadata::CAL_BINS];     // Histogram of window maximums
+                uint32_t            vPeaks[meta::trigger_metadata::CAL_BINS];       // Histogram of local peaks
+                size_t              nWindow;            // Size of the window in samples
+                size_t              nLeft;              // Number of samples left for the current window
+                float               fLevel;             // Maximum of the current window
+                float               fPrev;              // Maximum of the previous window
+                float               fPrev2;             // Maximum of the window before previous
+                size_t              nWindows;           // Number of windows
+                size_t              nPeaks;             // Number of peaks
+
+            protected:
+                static size_t       level_to_bin(float level);
+                static float        bin_to_db(size_t bin);
+                static size_t       percentile(const uint32_t *hist, size_t first, float p);
+
+            public:
+                explicit TriggerCalibrator();
+                TriggerCalibrator(const TriggerCalibrator &) = delete;
+                TriggerCalibrator(TriggerCalibrator &&) = delete;
+                ~TriggerCalibrator();
+
+                TriggerCalibrator & operator = (const TriggerCalibrator &) = delete;
+                TriggerCalibrator & operator = (TriggerCalibrator &&) = delete;
+
+            public:
+                void                set_sample_rate(size_t sr);
+
+                /** Drop all collected statistics
+                 *
+                 */
+                void                reset();
+
+                /** Collect statistics
+                 *
+                 * @param sc trigger function
+                 * @param samples number of samples
+                 */
+                void                process(const float *sc, size_t samples);
+
+                /** Estimate trigger parameters
+                 *
+                 * @param dst destination to store parameters
+                 * @param dynamics current dynamics of the trigger
+                 * @return true if there is enough statistics to estimate parameters
+                 */
+                bool                analyze(calibration_t *dst, float dynamics) const;
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_TRIGGER_CALIBRATOR_H_ */
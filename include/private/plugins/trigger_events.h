@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_TRIGGER_EVENTS_H_
+#define PRIVATE_PLUGINS_TRIGGER_EVENTS_H_
+
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <lsp-plug.in/common/atomic.h>
+
+#include <private/meta/trigger.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Trigger event
+         */
+        typedef struct trigger_event_t
+        {
+            wsize_t             nTimestamp;         // Absolute position of the event in samples
+            float               fLevel;             // Raw level of the trigger function
+            float               fVelocity;          // Computed normalized velocity
+            ssize_t             nFile;              // Index of the chosen sample file, negative if none
+            ssize_t             nDelay;             // Delay of the playback including time drift, samples
+        } trigger_event_t;
+
+        /**
+         * Fixed-size log of trigger events. There is only one writer (the audio thread) which
+         * never waits. Each slot has a sequence number: the writer invalidates it before filling
+         * the slot and publishes it on commit, the reader checks it before and after copying
+         * the event and drops the copy if the slot has been rewritten in between.
+         */
+        class TriggerEventLog
+        {
+            protected:
+                typedef struct slot_t
+                {
+                    trigger_event_t     sEvent;     // Event data
+                    uatomic_t           nSeq;       // Number of the event in the slot plus one, zero while being filled
+                } slot_t;
+
+            protected:
+                slot_t              vSlots[meta::trigger_metadata::EVENT_LOG_SIZE];     // Ring buffer with events
+                uatomic_t           nHead;                                              // Number of committed events
+
+            public:
+                explicit TriggerEventLog();
+                TriggerEventLog(const TriggerEventLog &) = delete;
+                TriggerEventLog(TriggerEventLog &&) = delete;
+                ~TriggerEventLog();
+
+                TriggerEventLog & operator = (const TriggerEventLog &) = delete;
+                TriggerEventLog & operator = (TriggerEventLog &&) = delete;
+
+            public:
+                /** Get the event slot to fill, the slot becomes visible to readers after commit()
+                 *
+                 * @return pointer to the event slot
+                 */
+                inline trigger_event_t *begin()
+                {
+                    slot_t *s = &vSlots[nHead & (meta::trigger_metadata::EVENT_LOG_SIZE - 1)];
+                    atomic_store(&s->nSeq, 0);
+                    return &s->sEvent;
+                }
+
+                /** Commit the event obtained by begin()
+                 *
+                 */
+                inline void         commit()
+                {
+                    const uatomic_t head = nHead + 1;
+                    atomic_store(&vSlots[nHead & (meta::trigger_metadata::EVENT_LOG_SIZE - 1)].nSeq, head);
+                    atomic_store(&nHead, head);
+                }
+
+                /** Get overall number of events committed to the log, the value wraps around
+                 *
+                 * @return overall number of events committed to the log
+                 */
+                inline uatomic_t    head() const
+                {
+                    return atomic_load(&nHead);
+                }
+
+                /** Read the event
+                 *
+                 * @param dst destination to store the event
+                 * @param index index of the event, should be less than head()
+                 * @return true if the event has been read, false if it has been overwritten
+                 *   before or during the read
+                 */
+                bool                get(trigger_event_t *dst, uatomic_t index) const;
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_TRIGGER_EVENTS_H_ */
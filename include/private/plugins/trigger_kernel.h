@@ -33,6 +33,9 @@
 #include <lsp-plug.in/ipc/ITask.h>
 
 #include <private/meta/trigger.h>
+#include <private/plugins/sample_cache.h>
+#include <private/plugins/trigger_events.h>
+#include <private/plugins/trigger_profiler.h>
 
 namespace lsp
 {
@@ -76,6 +79,20 @@ namespace lsp
                         void                    dump(dspu::IStateDumper *v) const;
                 };
 
+                class KitLoader: public ipc::ITask
+                {
+                    private:
+                        trigger_kernel         *pCore;
+
+                    public:
+                        explicit KitLoader(trigger_kernel *base);
+                        virtual ~KitLoader();
+
+                    public:
+                        virtual status_t        run();
+                        void                    dump(dspu::IStateDumper *v) const;
+                };
+
                 class GCTask: public ipc::ITask
                 {
                     private:
@@ -91,6 +108,28 @@ namespace lsp
                 };
 
             protected:
+                enum cache_state_t
+                {
+                    CACHE_NONE,                                                         // Cache is not initialized
+                    CACHE_INIT,                                                         // Cache is being initialized
+                    CACHE_READY                                                         // Cache initialization is complete
+                };
+
+                typedef struct voice_t
+                {
+                    voice_t            *pNext;                                          // Next voice in the list
+                    dspu::Sample       *pSample;                                        // Sample being played, referenced by the voice
+                    ssize_t             nOffset;                                        // Current playback offset in sample
+                    float               fFrac;                                          // Fractional part of the playback offset
+                    float               fRate;                                          // Playback rate, defines the pitch
+                    bool                bListen;                                        // Voice is started by the listen button
+                    ssize_t             nTime;                                          // Number of played output samples, negative value means delay
+                    ssize_t             nFadeStart;                                     // Time of the fade-out start in output samples
+                    ssize_t             nFadeLength;                                    // Length of the fade-out in output samples
+                    ssize_t             nEnd;                                           // Time of the playback end in output samples
+                    float               vGains[meta::trigger_metadata::TRACKS_MAX][meta::trigger_metadata::TRACKS_MAX]; // Sample channel to output channel gain matrix
+                } voice_t;
+
                 struct afile_t
                 {
                     uint32_t            nID;                                            // ID of sample
@@ -100,13 +139,24 @@ namespace lsp
                     dspu::Toggle        sStop;                                          // Stop toggle
                     dspu::Blink         sNoteOn;                                        // Note on led
                     dspu::Sample       *pOriginal;                                      // Source sample (original, as from source file)
+                    dspu::Sample       *pResampled;                                     // Source sample resampled with high quality, reused by renders
                     dspu::Sample       *pProcessed;                                     // Processed sample
+                    uint64_t            nSource;                                        // Hash of the source file identity for the sample cache
                     float              *vThumbs[meta::trigger_metadata::TRACKS_MAX];    // List of thumbnails
-                    dspu::Playback      vPlaybacks[4];                                  // Playbacks
+                    voice_t            *pVoices;                                        // List of triggered voices
 
                     uint32_t            nUpdateReq;                                     // Update request
                     uint32_t            nUpdateResp;                                    // Update response
                     bool                bSync;                                          // Sync flag
+                    bool                bStaged;                                        // Processed sample is waiting for the kit switch
+                    bool                bDraft;                                         // The sample is rendered with draft quality
+                    bool                bDraftReq;                                      // Draft quality is requested for the next render
+                    size_t              nSettle;                                        // Time left to replace the draft render (samples)
+                    bool                bCache;                                         // Store the result of the current render to the cache
+                    bool                bCacheReq;                                      // Store the result of the next render to the cache
+                    bool                bBulk;                                          // The file is loaded as a part of the kit
+                    status_t            nBulkStatus;                                    // Loading status of the file loaded as a part of the kit
+                    uatomic_t           nBulkDone;                                      // The kit worker has published the result of the file
                     float               fVelocity;                                      // Velocity
                     float               fPitch;                                         // Pitch (st)
                     float               fHeadCut;                                       // Head cut (ms)
@@ -146,27 +196,55 @@ namespace lsp
                 ipc::IExecutor     *pExecutor;                                          // Executor service
                 afile_t            *vFiles;                                             // List of audio files
                 afile_t           **vActive;                                            // List of active audio files
+                voice_t            *vVoices;                                            // Pool of voices
+                voice_t            *pFreeVoices;                                        // List of free voices
                 dspu::Sample       *pGCList;                                            // Garbage collection list
+                dspu::Sample       *pGCPending;                                         // Retired samples waiting for the garbage collection
+                size_t              nGCCount;                                           // Number of pending retired samples
+                size_t              nGCBytes;                                           // Size of pending retired sample data
+                size_t              nGCTimer;                                           // Time left to start garbage collection
                 dspu::SamplePlayer  vChannels[meta::trigger_metadata::TRACKS_MAX];      // List of channels
                 dspu::Bypass        vBypass[meta::trigger_metadata::TRACKS_MAX];        // List of bypasses
                 dspu::Blink         sActivity;                                          // Note on led for instrument
                 dspu::Randomizer    sRandom;                                            // Randomizer
                 GCTask              sGCTask;                                            // Garbage collection task
+                KitLoader           sKitLoader;                                         // Kit loading task
+                afile_t           **vKitFiles;                                          // List of files loaded as a kit
+                size_t              nKitFiles;                                          // Number of files loaded as a kit
+                uatomic_t           nKitNext;                                           // Next file of the kit to load
+                uatomic_t           nKitDone;                                           // Number of loaded files of the kit
+                size_t              nLoadDefer;                                         // Number of renders submitted while file loads are waiting
+                SampleCache         sCache;                                             // Cache of rendered samples
+                uatomic_t           nCacheState;                                        // Initialization state of the cache
 
                 size_t              nFiles;                                             // Number of files
                 size_t              nActive;                                            // Number of active files
                 size_t              nChannels;                                          // Number of audio channels (mono/stereo)
-                float              *vBuffer;                                            // Buffer
+                size_t              nVoices;                                            // Number of active voices
+                float              *vBuffer;                                            // Buffer for resampled channels of pitched voices
+                int32_t            *vIndex;                                             // Integer parts of sample positions of pitched voices
+                float              *vFrac;                                              // Fractional parts of sample positions of pitched voices
+                float              *vTaps;                                              // Gathered taps and kernel weights of pitched voices
+                float              *vAAKernel;                                          // Anti-aliasing kernel for pitched voices
                 bool                bBypass;                                            // Bypass flag
                 bool                bReorder;                                           // Reorder flag
+                bool                bAtomicKit;                                         // Switch all samples of the kit at once
                 float               fFadeout;                                           // Fadeout in milliseconds
                 float               fDynamics;                                          // Dynamics
                 float               fDrift;                                             // Time drifting
+                float               fPitchVar;                                          // Pitch variation (st)
+                float               fGain;                                              // Output gain of the sampled signal
                 size_t              nSampleRate;                                        // Sample rate
 
                 plug::IPort        *pDynamics;                                          // Dynamics port
                 plug::IPort        *pDrift;                                             // Time drifting port
+                plug::IPort        *pKitSwitch;                                         // Atomic kit switching port
+                plug::IPort        *pKitPending;                                        // Kit switch pending indicator
+                plug::IPort        *pPitchVar;                                          // Pitch variation port
+                plug::IPort        *pQueueDepth;                                        // Number of submitted background tasks
+                plug::IPort        *pKitProgress;                                       // Kit loading progress
                 plug::IPort        *pActivity;                                          // Activity port
+                TriggerProfiler    *pProfiler;                                          // Profiler of processing stages
                 uint8_t            *pData;                                              // Pointer to aligned data
 
 
@@ -175,18 +253,39 @@ namespace lsp
                 static void         destroy_afile(afile_t *af);
                 static void         destroy_samples(dspu::Sample *gc_list);
                 static void         destroy_sample(dspu::Sample * &sample);
+                static void         kit_worker(void *arg);
+                static bool         file_busy(const afile_t *af);
 
             protected:
                 void        destroy_state();
                 void        perform_gc();
+                void        retire_sample(dspu::Sample *s);
+                void        drop_staged_sample(afile_t *af);
+                status_t    decode_file(dspu::Sample *dst, const char *fname);
                 status_t    load_file(afile_t *file);
+                bool        enable_cache();
                 status_t    render_sample(afile_t *af);
-                void        play_sample(const afile_t *af, float gain, size_t delay);
-                void        cancel_sample(const afile_t *af, size_t fadeout, size_t delay);
+                status_t    load_kit();
+                void        run_kit_worker();
+                bool        submit_kit();
+                void        commit_kit();
+                void        play_sample(afile_t *af, float gain, size_t delay, float pitch, bool listen);
+                void        cancel_sample(afile_t *af, size_t fadeout, size_t delay);
+                void        cancel_voices(afile_t *af, size_t fadeout, size_t delay, bool listen);
+                void        free_voice(voice_t *v);
+                void        drop_voices(afile_t *af);
+                size_t      resample_voice(voice_t *v, const float **dst, size_t samples);
+                bool        mix_voice(voice_t *v, float **outs, size_t samples);
+                void        mix_voices(float **outs, size_t samples);
 
                 void        process_file_load_requests();
                 void        process_file_render_requests();
-                void        process_gc_tasks();
+                void        process_draft_renders(size_t samples);
+                void        process_gc_tasks(size_t samples);
+                bool        kit_busy() const;
+                bool        renders_pending() const;
+                size_t      queue_depth() const;
+                void        commit_staged_samples();
                 void        reorder_samples();
                 void        process_listen_events();
                 void        play_samples(float **outs, const float **ins, size_t samples);
@@ -206,12 +305,20 @@ namespace lsp
                 virtual ~trigger_kernel();
 
             public:
-                void        trigger_on(size_t timestamp, float level);
+                /** Trigger the sample
+                 *
+                 * @param timestamp offset of the event in samples
+                 * @param level normalized velocity
+                 * @param event event to store the chosen sample file and the playback delay, may be NULL
+                 */
+                void        trigger_on(size_t timestamp, float level, trigger_event_t *event);
                 void        trigger_off(size_t timestamp, float level);
                 void        trigger_stop(size_t timestamp);
 
             public:
                 void        set_fadeout(float length);
+                void        set_gain(float gain);
+                void        set_profiler(TriggerProfiler *profiler);
 
             public:
                 bool        init(ipc::IExecutor *executor, size_t files, size_t channels);
@@ -223,14 +330,27 @@ namespace lsp
                 void        update_sample_rate(long sr);
                 void        sync_samples_with_ui();
 
-                /** Process the sampler kernel
+                /** Check that the kernel does not produce any sound and has no pending listen events
+                 *
+                 * @return true if kernel is idle
+                 */
+                bool        idle() const;
+
+                /** Process the sampler kernel: the sampled signal is multiplied by the output gain
+                 * and added to the input signal
                  *
-                 * @param outs list of outputs (should be not the sampe as ins)
-                 * @param ins list of inputs, elements may be NULL
+                 * @param outs list of outputs, may be the same as ins for in-place processing
+                 * @param ins list of inputs, may be NULL
                  * @param samples number of samples to process
                  */
                 void        process(float **outs, const float **ins, size_t samples);
 
+                /** Process only background tasks and output parameters of the idle kernel
+                 *
+                 * @param samples number of samples to process
+                 */
+                void        process_idle(size_t samples);
+
                 void        dump(dspu::IStateDumper *v) const;
         };
     } /* namespace plugins */
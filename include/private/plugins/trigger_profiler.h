@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_TRIGGER_PROFILER_H_
+#define PRIVATE_PLUGINS_TRIGGER_PROFILER_H_
+
+#include <lsp-plug.in/plug-fw/plug.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Lightweight profiler of the trigger processing stages. Stages are measured
+         * one after another: each call of end() accounts the time elapsed since the
+         * previous call of begin() or end() to the specified stage.
+         */
+        class TriggerProfiler
+        {
+            public:
+                enum stage_t
+                {
+                    ST_SIDECHAIN,           // Sidechain processing
+                    ST_DETECTOR,            // Trigger detector and signal analysis
+                    ST_HOUSEKEEPING,        // Loading, rendering, garbage collection of samples
+                    ST_VOICES,              // Mixing of triggered voices and listen previews
+                    ST_OUTPUT,              // Dry signal and output mixing
+
+                    ST_TOTAL
+                };
+
+            protected:
+                wsize_t             vBlock[ST_TOTAL];       // Time spent in the current block, ns
+                wsize_t             vLast[ST_TOTAL];        // Time spent in the last block, ns
+                wsize_t             vPeak[ST_TOTAL];        // Peak time spent per block, ns
+                wsize_t             vOverall[ST_TOTAL];     // Overall time spent, ns
+                wsize_t             nStamp;                 // Last time stamp, ns
+                wsize_t             nBlocks;                // Number of measured blocks
+                wsize_t             nSamples;               // Number of measured samples
+                bool                bEnabled;               // Profiling is enabled
+
+            protected:
+                static wsize_t      now();
+
+            public:
+                explicit TriggerProfiler();
+                TriggerProfiler(const TriggerProfiler &) = delete;
+                TriggerProfiler(TriggerProfiler &&) = delete;
+                ~TriggerProfiler();
+
+                TriggerProfiler & operator = (const TriggerProfiler &) = delete;
+                TriggerProfiler & operator = (TriggerProfiler &&) = delete;
+
+            public:
+                /** Enable or disable profiling, statistics is reset on enable
+                 *
+                 * @param enabled enable flag
+                 */
+                void                set_enabled(bool enabled);
+
+                inline bool         enabled() const                 { return bEnabled;          }
+
+                /** Start measurement
+                 *
+                 */
+                inline void         begin()
+                {
+                    if (bEnabled)
+                        nStamp          = now();
+                }
+
+                /** Account time elapsed since the last measurement to the stage
+                 *
+                 * @param stage stage to account the time
+                 */
+                inline void         end(stage_t stage)
+                {
+                    if (!bEnabled)
+                        return;
+                    const wsize_t stamp = now();
+                    vBlock[stage]      += stamp - nStamp;
+                    nStamp              = stamp;
+                }
+
+                /** Complete the measurement of the processing block
+                 *
+                 * @param samples number of samples in the block
+                 */
+                void                commit(size_t samples);
+
+                /** Get time spent on the stage in the last block
+                 *
+                 * @param stage processing stage
+                 * @return time in nanoseconds
+                 */
+                inline wsize_t      last(stage_t stage) const       { return vLast[stage];      }
+
+                /** Get overall time spent on the stage since profiling has been enabled
+                 *
+                 * @param stage processing stage
+                 * @return time in nanoseconds
+                 */
+                inline wsize_t      overall(stage_t stage) const    { return vOverall[stage];   }
+
+                /** Get number of samples processed since profiling has been enabled
+                 *
+                 * @return number of samples
+                 */
+                inline wsize_t      samples() const                 { return nSamples;          }
+
+                /** Get processing throughput since profiling has been enabled
+                 *
+                 * @return number of samples processed per second of processing time
+                 */
+                double              throughput() const;
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_TRIGGER_PROFILER_H_ */
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_WORKER_POOL_H_
+#define PRIVATE_PLUGINS_WORKER_POOL_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Helper threads for parallel background work, shared by all plugin instances of the process.
+         * The caller thread always takes part in the work, helper threads are started only while the
+         * overall number of running helpers in the process stays below the global limit. Nested and
+         * concurrent jobs of several instances therefore never oversubscribe the CPU and never wait
+         * for each other: a job which gets no helpers is just done by the caller thread.
+         */
+        class WorkerPool
+        {
+            public:
+                /** Worker function, should take items of the job until there are no more items
+                 *
+                 * @param arg argument of the job
+                 */
+                typedef void (* worker_t)(void *arg);
+
+            protected:
+                static constexpr size_t HELPERS_MAX         = 8;        // Maximum number of helper threads of one job
+
+                typedef struct job_t
+                {
+                    worker_t            pWorker;                        // Worker function
+                    void               *pArg;                           // Argument of the worker function
+                } job_t;
+
+            protected:
+                static size_t       limit();
+                static size_t       acquire(size_t count);
+                static void         release(size_t count);
+                static status_t     helper(void *arg);
+
+            public:
+                /** Run the job in the caller thread and in helper threads
+                 *
+                 * @param worker worker function
+                 * @param arg argument of the worker function
+                 * @param threads maximum number of threads including the caller thread
+                 * @return number of threads which have run the worker
+                 */
+                static size_t       run(worker_t worker, void *arg, size_t threads);
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_WORKER_POOL_H_ */
@@ -25,12 +25,30 @@
 #include <lsp-plug.in/plug-fw/ui.h>
 #include <lsp-plug.in/fmt/Hydrogen.h>
 
+#include <private/ui/trigger_events.h>
+
 namespace lsp
 {
     namespace plugui
     {
         class trigger: public ui::Module
         {
+            protected:
+                typedef struct calibration_t
+                {
+                    ui::IPort          *pSource;        // Calibrated value
+                    ui::IPort          *pTarget;        // Control port to apply the value
+                } calibration_t;
+
+            protected:
+                ui::IPort          *pApplyCalibration;  // Apply calibration trigger
+                calibration_t       vCalibration[4];    // List of calibrated values
+                ui::IPort          *pEventLog;          // Trigger event log
+                trigger_events::LastHitPort    *vLastHit[trigger_events::F_TOTAL];  // Fields of the last hit
+
+            protected:
+                void                apply_calibration();
+
             public:
                 explicit trigger(const meta::plugin_t *meta);
                 trigger(const trigger &) = delete;
@@ -41,6 +59,7 @@ namespace lsp
                 trigger & operator = (trigger &&) = delete;
 
                 virtual status_t    init(ui::IWrapper *wrapper) override;
+                virtual void        notify(ui::IPort *port, size_t flags) override;
         };
     } /* namespace plugui */
 } /* namespace lsp */
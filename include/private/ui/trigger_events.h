@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_UI_TRIGGER_EVENTS_H_
+#define PRIVATE_UI_TRIGGER_EVENTS_H_
+
+#include <lsp-plug.in/plug-fw/ui.h>
+
+namespace lsp
+{
+    namespace plugui
+    {
+        namespace trigger_events
+        {
+            enum hit_field_t
+            {
+                F_LEVEL,
+                F_VELOCITY,
+                F_SAMPLE,
+                F_DELAY,
+
+                F_TOTAL
+            };
+
+            /**
+             * UI-side port that shows one field of the last trigger event received
+             * from the trigger event log
+             */
+            class LastHitPort: public ui::IPort
+            {
+                protected:
+                    float               fValue;         // Current value
+
+                public:
+                    explicit LastHitPort(hit_field_t field);
+                    LastHitPort(const LastHitPort &) = delete;
+                    LastHitPort(LastHitPort &&) = delete;
+                    virtual ~LastHitPort() override;
+
+                    LastHitPort & operator = (const LastHitPort &) = delete;
+                    LastHitPort & operator = (LastHitPort &&) = delete;
+
+                public:
+                    virtual float       value() override;
+                    virtual void        set_value(float value) override;
+            };
+
+            /**
+             * Update the last hit ports from the event log mesh
+             * @param ports list of F_TOTAL ports, elements may be NULL
+             * @param log event log port
+             */
+            void update_last_hit(LastHitPort **ports, ui::IPort *log);
+
+        } /* namespace trigger_events */
+    } /* namespace plugui */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UI_TRIGGER_EVENTS_H_ */
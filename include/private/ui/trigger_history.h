@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UI_TRIGGER_HISTORY_H_
+#define PRIVATE_UI_TRIGGER_HISTORY_H_
+
+#include <lsp-plug.in/plug-fw/ui.h>
+
+namespace lsp
+{
+    namespace plugui
+    {
+        namespace trigger_history
+        {
+            enum history_t
+            {
+                H_INPUT,
+                H_FUNCTION,
+                H_VELOCITY
+            };
+
+            /**
+             * Proxy port that receives incremental updates of the history graph
+             * from the DSP side and provides the complete mesh to the widgets
+             */
+            class HistoryMeshPort: public ui::ProxyPort
+            {
+                protected:
+                    history_t           enType;         // Type of history graph
+                    size_t              nHead;          // Position of the oldest dot in the ring
+                    float              *vRing;          // Ring buffer with history dots
+                    plug::mesh_t       *pMesh;          // Complete mesh
+                    uint8_t            *pData;          // Allocated data
+
+                protected:
+                    void                build_mesh();
+
+                public:
+                    HistoryMeshPort();
+                    virtual ~HistoryMeshPort();
+
+                public:
+                    /**
+                     * Initialize the proxy port
+                     * @param id identifier of the proxy port
+                     * @param port port that delivers incremental updates
+                     * @param tpl metadata of the complete mesh port the proxy mimics
+                     * @param type type of history graph
+                     * @return status of operation
+                     */
+                    status_t            init(const char *id, ui::IPort *port, const meta::port_t *tpl, history_t type);
+
+                public: // ui::ProxyPort
+                    virtual void       *buffer() override;
+                    virtual void        notify(ui::IPort *port, size_t flags) override;
+            };
+
+        } /* namespace trigger_history */
+    } /* namespace plugui */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UI_TRIGGER_HISTORY_H_ */
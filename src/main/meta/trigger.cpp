@@ -27,7 +27,7 @@
 
 #define LSP_PLUGINS_TRIGGER_VERSION_MAJOR                   1
 #define LSP_PLUGINS_TRIGGER_VERSION_MINOR                   0
-#define LSP_PLUGINS_TRIGGER_VERSION_MICRO                   33
+#define LSP_PLUGINS_TRIGGER_VERSION_MICRO                   34
 
 #define LSP_PLUGINS_TRIGGER_VERSION  \
     LSP_MODULE_VERSION( \
@@ -78,6 +78,18 @@ namespace lsp
             { NULL, NULL }
         };
 
+        static const port_item_t trigger_history_zoom[] =
+        {
+            { "0.625 s",    NULL },
+            { "1.25 s",     NULL },
+            { "2.5 s",      NULL },
+            { "5 s",        NULL },
+            { "10 s",       NULL },
+            { "20 s",       NULL },
+            { "40 s",       NULL },
+            { NULL, NULL }
+        };
+
         static const port_item_t trigger_filter_slope[] =
         {
             { "off",        "eq.slope.off"      },
@@ -118,6 +130,7 @@ namespace lsp
 
         #define T_METERS_MONO                   \
             MESH("isg", "Input signal graph", trigger_metadata::TRACKS_MAX, trigger_metadata::HISTORY_MESH_SIZE + 2), \
+            MESH("isgd", "Input signal graph history", trigger_metadata::TRACKS_MAX, trigger_metadata::HISTORY_MESH_SIZE), \
             METER_GAIN20("ism", "Input signal meter"), \
             SWITCH("isv", "Input signal display", "Show in", 1.0f)
 
@@ -125,6 +138,8 @@ namespace lsp
             COMBO("ssrc", "Signal source", "Source", 0, trigger_sources), \
             MESH("isgl", "Input signal graph left", trigger_metadata::TRACKS_MAX, trigger_metadata::HISTORY_MESH_SIZE + 2), \
             MESH("isgr", "Input signal graph right", trigger_metadata::TRACKS_MAX, trigger_metadata::HISTORY_MESH_SIZE + 2), \
+            MESH("isgld", "Input signal graph history left", trigger_metadata::TRACKS_MAX, trigger_metadata::HISTORY_MESH_SIZE), \
+            MESH("isgrd", "Input signal graph history right", trigger_metadata::TRACKS_MAX, trigger_metadata::HISTORY_MESH_SIZE), \
             METER_GAIN20("isml", "Input signal meter left"), \
             METER_GAIN20("ismr", "Input signal meter right"), \
             SWITCH("isvl", "Input signal left display", "Show in L", 1.0f), \
@@ -141,6 +156,7 @@ namespace lsp
             COMBO("mode", "Detection mode", "Mode", trigger_metadata::MODE_DFL, trigger_modes), \
             SWITCH("pause", "Pause graph analysis", "Pause", 0.0f), \
             TRIGGER("clear", "Clear graph analysis", "Clear"), \
+            COMBO("hzoom", "Graph analysis time window", "Time window", trigger_metadata::HISTORY_ZOOM_DFL, trigger_history_zoom), \
             AMP_GAIN100("preamp", "Signal pre-amplification", "Preamp", 1.0f), \
             COMBO("shpm", "High-pass filter mode", "HPF mode", 0, trigger_filter_slope),      \
             LOG_CONTROL("shpf", "High-pass filter frequency", "HPF freq", U_HZ, trigger_metadata::HPF),   \
@@ -156,19 +172,43 @@ namespace lsp
             CONTROL("react", "Reactivity", "Reactivity", U_MSEC, trigger_metadata::REACTIVITY), \
             METER_OUT_GAIN("rl", "Release level", 20.0f), \
             MESH("tfg", "Trigger function graph", trigger_metadata::TRACKS_MAX, trigger_metadata::HISTORY_MESH_SIZE), \
+            MESH("tfgd", "Trigger function graph history", trigger_metadata::TRACKS_MAX, trigger_metadata::HISTORY_MESH_SIZE), \
             METER_GAIN20("tfm", "Trigger function meter"), \
             SWITCH("tfv", "Trigger function display", "Show func", 1.0f), \
             BLINK("tla", "Trigger activity"), \
             MESH("tlg", "Trigger level graph", trigger_metadata::TRACKS_MAX, trigger_metadata::HISTORY_MESH_SIZE + 4), \
+            MESH("tlgd", "Trigger level graph history", trigger_metadata::TRACKS_MAX, trigger_metadata::HISTORY_MESH_SIZE), \
             METER_GAIN20("tlm", "Trigger level meter"), \
             SWITCH("tlv", "Trigger level display", "Show lvl", 1.0f), \
+            MESH("tevl", "Trigger event log", 5, trigger_metadata::EVENT_LOG_SIZE), \
+            SWITCH("prof", "Profile processing stages", "Profiling", 0.0f), \
+            METER("ldsc", "Sidechain DSP load", U_PERCENT, trigger_metadata::DSP_LOAD), \
+            METER("lddt", "Detector DSP load", U_PERCENT, trigger_metadata::DSP_LOAD), \
+            METER("ldhk", "Sample housekeeping DSP load", U_PERCENT, trigger_metadata::DSP_LOAD), \
+            METER("ldvc", "Voice mixing DSP load", U_PERCENT, trigger_metadata::DSP_LOAD), \
+            METER("ldout", "Output mixing DSP load", U_PERCENT, trigger_metadata::DSP_LOAD), \
+            SWITCH("cal", "Calibrate trigger thresholds", "Calibrate", 0.0f), \
+            TRIGGER("capp", "Apply calibrated thresholds", "Apply cal"), \
+            METER_OUT_GAIN("cdl", "Calibrated detect level", 20.0f), \
+            METER_OUT_GAIN("crrl", "Calibrated relative release level", 1.0f), \
+            METER_OUT_GAIN("cdtr1", "Calibrated dynamics range 1", 20.0f), \
+            METER_OUT_GAIN("cdtr2", "Calibrated dynamics range 2", 20.0f), \
+            CONTROL("idr", "Inline display refresh rate", "Display rate", U_HZ, trigger_metadata::IDISPLAY_RATE), \
+            SWITCH("kswa", "Atomic kit switching", "Atomic kit", 0.0f), \
+            BLINK("kswp", "Kit switch pending"), \
+            CONTROL("pvar", "Pitch variation", "Pitch var", U_SEMITONES, trigger_metadata::PITCH_VAR), \
+            INT_METER("kqd", "Background task queue depth", U_NONE, trigger_metadata::QUEUE_DEPTH), \
+            METER("klp", "Kit loading progress", U_PERCENT, trigger_metadata::KIT_PROGRESS), \
             PORT_SET("ssel", "Sample selector", trigger_sample_selectors, sample)
 
         #define T_MIDI_PORTS                    \
             COMBO("chan", "Channel", "MIDI channel", trigger_metadata::MIDI_CHANNEL_DFL, midi_channels), \
             COMBO("note", "Note", "Note", trigger_metadata::MIDI_NOTE_DFL, notes), \
             COMBO("oct", "Octave", "Octave", trigger_metadata::MIDI_OCTAVE_DFL, octaves), \
-            INT_METER("mn", "MIDI Note #", U_NONE, trigger_metadata::MIDINOTE)
+            INT_METER("mn", "MIDI Note #", U_NONE, trigger_metadata::MIDINOTE), \
+            SWITCH("mrec", "Record MIDI events", "Record MIDI", 0.0f), \
+            PATH("mexf", "MIDI export file"), \
+            STATUS("mexs", "MIDI export status")
 
         static const port_t sample_file_mono_ports[] =
         {
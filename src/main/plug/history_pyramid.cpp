@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#include <private/plugins/history_pyramid.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        HistoryPyramid::HistoryPyramid()
+        {
+            construct();
+        }
+
+        HistoryPyramid::~HistoryPyramid()
+        {
+            destroy();
+        }
+
+        void HistoryPyramid::construct()
+        {
+            vLevels         = NULL;
+            nLevels         = 0;
+            nSize           = 0;
+            pData           = NULL;
+        }
+
+        void HistoryPyramid::destroy()
+        {
+            free_aligned(pData);
+            vLevels         = NULL;
+            nLevels         = 0;
+            nSize           = 0;
+        }
+
+        bool HistoryPyramid::init(size_t levels, size_t size)
+        {
+            if ((levels <= 0) || (size <= 0))
+                return false;
+
+            // Allocate memory for all levels at once
+            const size_t szof_levels    = align_size(sizeof(level_t) * levels, DEFAULT_ALIGN);
+            const size_t szof_ring      = align_size(sizeof(float) * size, DEFAULT_ALIGN);
+            const size_t allocate       = szof_levels + szof_ring * levels;
+
+            uint8_t *data               = NULL;
+            uint8_t *ptr                = alloc_aligned<uint8_t>(data, allocate);
+            if (ptr == NULL)
+                return false;
+
+            // Replace the previously allocated data
+            free_aligned(pData);
+            pData                       = data;
+            vLevels                     = advance_ptr_bytes<level_t>(ptr, szof_levels);
+            nLevels                     = levels;
+            nSize                       = size;
+
+            for (size_t i=0; i<levels; ++i)
+            {
+                level_t *l                  = &vLevels[i];
+                l->vRing                    = advance_ptr_bytes<float>(ptr, szof_ring);
+                l->nHead                    = 0;
+                l->nDots                    = 0;
+                l->fPending                 = 0.0f;
+                l->bPending                 = false;
+
+                dsp::fill_zero(l->vRing, size);
+            }
+
+            return true;
+        }
+
+        void HistoryPyramid::process(float value)
+        {
+            for (size_t i=0; i<nLevels; ++i)
+            {
+                level_t *l                  = &vLevels[i];
+
+                // Store the dot
+                l->vRing[l->nHead]          = value;
+                if ((++l->nHead) >= nSize)
+                    l->nHead                    = 0;
+                ++l->nDots;
+
+                // Each second dot produces the dot for the next level
+                if (!l->bPending)
+                {
+                    l->fPending                 = value;
+                    l->bPending                 = true;
+                    return;
+                }
+
+                value                       = lsp_max(l->fPending, value);
+                l->bPending                 = false;
+            }
+        }
+
+        void HistoryPyramid::read(size_t level, float *dst, size_t count) const
+        {
+            const level_t *l            = &vLevels[level];
+            count                       = lsp_min(count, nSize);
+
+            // The ring buffer may be split into two parts
+            if (count <= l->nHead)
+                dsp::copy(dst, &l->vRing[l->nHead - count], count);
+            else
+            {
+                const size_t tail           = count - l->nHead;
+                dsp::copy(dst, &l->vRing[nSize - tail], tail);
+                dsp::copy(&dst[tail], l->vRing, l->nHead);
+            }
+        }
+
+        void HistoryPyramid::clear()
+        {
+            for (size_t i=0; i<nLevels; ++i)
+            {
+                level_t *l                  = &vLevels[i];
+                dsp::fill_zero(l->vRing, nSize);
+                l->fPending                 = 0.0f;
+                l->bPending                 = false;
+            }
+        }
+
+        void HistoryPyramid::dump(dspu::IStateDumper *v) const
+        {
+            v->begin_array("vLevels", vLevels, nLevels);
+            {
+                for (size_t i=0; i<nLevels; ++i)
+                {
+                    const level_t *l            = &vLevels[i];
+                    v->begin_object(l, sizeof(level_t));
+                    {
+                        v->write("vRing", l->vRing);
+                        v->write("nHead", l->nHead);
+                        v->write("nDots", l->nDots);
+                        v->write("fPending", l->fPending);
+                        v->write("bPending", l->bPending);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+
+            v->write("nLevels", nLevels);
+            v->write("nSize", nSize);
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
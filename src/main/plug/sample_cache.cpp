@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/io/Dir.h>
+#include <lsp-plug.in/io/File.h>
+#include <lsp-plug.in/io/InFileStream.h>
+#include <lsp-plug.in/io/NativeFile.h>
+#include <lsp-plug.in/io/OutFileStream.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <stdlib.h>
+
+#include <private/plugins/sample_cache.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static const uint8_t cache_signature[4] = { 'L', 'T', 'S', 'C' };
+        static const uint8_t cache_trailer[4]   = { 'C', 'S', 'T', 'L' };
+        static constexpr uint32_t CACHE_VERSION = 3;
+
+        static_assert(sizeof(SampleCache::key_t) == 48, "Cache key should not contain implicit padding");
+
+        static uatomic_t cache_counter          = 0;
+
+        static status_t read_fully(io::InFileStream *is, void *buf, size_t count)
+        {
+            uint8_t *ptr        = static_cast<uint8_t *>(buf);
+            while (count > 0)
+            {
+                const ssize_t n     = is->read(ptr, count);
+                if (n < 0)
+                    return status_t(-n);
+                if (n == 0)
+                    return STATUS_CORRUPTED;
+                ptr                += n;
+                count              -= n;
+            }
+            return STATUS_OK;
+        }
+
+        static status_t write_fully(io::OutFileStream *os, const void *buf, size_t count)
+        {
+            const ssize_t n     = os->write(buf, count);
+            if (n < 0)
+                return status_t(-n);
+            return (size_t(n) == count) ? STATUS_OK : STATUS_IO_ERROR;
+        }
+
+        SampleCache::SampleCache()
+        {
+            nLimit          = 0;
+            bEnabled        = false;
+        }
+
+        SampleCache::~SampleCache()
+        {
+            bEnabled        = false;
+        }
+
+        uint64_t SampleCache::hash(uint64_t seed, const void *data, size_t size)
+        {
+            // FNV-1a
+            const uint8_t *ptr  = static_cast<const uint8_t *>(data);
+            for (size_t i=0; i<size; ++i)
+            {
+                seed           ^= ptr[i];
+                seed           *= 0x100000001b3ULL;
+            }
+            return seed;
+        }
+
+        int SampleCache::compare_entries(const void *a, const void *b)
+        {
+            const entry_t *ea   = static_cast<const entry_t *>(a);
+            const entry_t *eb   = static_cast<const entry_t *>(b);
+            return (ea->nTime < eb->nTime) ? -1 : (ea->nTime > eb->nTime) ? 1 : 0;
+        }
+
+        status_t SampleCache::init(const char *name, wsize_t limit)
+        {
+            bEnabled        = false;
+            nLimit          = limit;
+
+            status_t res    = system::get_temporary_dir(&sDirectory);
+            if (res != STATUS_OK)
+                return res;
+            if ((res = sDirectory.append_child(name)) != STATUS_OK)
+                return res;
+            if ((res = sDirectory.mkdir(true)) != STATUS_OK)
+            {
+                lsp_warn("Could not create sample cache directory %s", sDirectory.as_native());
+                return res;
+            }
+
+            bEnabled        = true;
+            return STATUS_OK;
+        }
+
+        uint64_t SampleCache::source_hash(const char *path)
+        {
+            io::fattr_t attr;
+            if (io::File::stat(path, &attr) != STATUS_OK)
+                return 0;
+
+            uint64_t h      = 0xcbf29ce484222325ULL;
+            h               = hash(h, path, strlen(path));
+            h               = hash(h, &attr.size, sizeof(attr.size));
+            h               = hash(h, &attr.mtime, sizeof(attr.mtime));
+
+            return (h != 0) ? h : 1;
+        }
+
+        status_t SampleCache::entry_path(io::Path *path, const key_t *key) const
+        {
+            char name[32];
+            const uint64_t h    = hash(0xcbf29ce484222325ULL, key, sizeof(key_t));
+            snprintf(name, sizeof(name), "%016llx.smp", (unsigned long long)h);
+
+            status_t res        = path->set(&sDirectory);
+            return (res == STATUS_OK) ? path->append_child(name) : res;
+        }
+
+        status_t SampleCache::load(const key_t *key, dspu::Sample *dst, float * const *thumbs) const
+        {
+            if ((!bEnabled) || (key->nSource == 0))
+                return STATUS_NOT_FOUND;
+
+            io::Path path;
+            status_t res        = entry_path(&path, key);
+            if (res != STATUS_OK)
+                return res;
+
+            io::InFileStream is;
+            if (is.open(&path) != STATUS_OK)
+                return STATUS_NOT_FOUND;
+            lsp_finally { is.close(); };
+
+            // Validate header
+            header_t hdr;
+            if ((res = read_fully(&is, &hdr, sizeof(hdr))) != STATUS_OK)
+                return res;
+            if ((memcmp(hdr.vSignature, cache_signature, sizeof(cache_signature)) != 0) ||
+                (hdr.nVersion != CACHE_VERSION) ||
+                (memcmp(&hdr.sKey, key, sizeof(key_t)) != 0) ||
+                (hdr.nChannels != key->nChannels))
+                return STATUS_CORRUPTED;
+
+            // Read thumbnails and sample data directly into the target buffers
+            const size_t channels   = hdr.nChannels;
+            const size_t length     = hdr.nLength;
+            if (!dst->init(channels, length, length))
+                return STATUS_NO_MEM;
+
+            for (size_t i=0; i<channels; ++i)
+                if ((res = read_fully(&is, thumbs[i], sizeof(float) * key->nThumbs)) != STATUS_OK)
+                    return res;
+            for (size_t i=0; i<channels; ++i)
+                if ((res = read_fully(&is, dst->channel(i), sizeof(float) * length)) != STATUS_OK)
+                    return res;
+
+            // The trailer is written last, it is missing if the entry was not written completely
+            uint8_t trailer[4];
+            if ((res = read_fully(&is, trailer, sizeof(trailer))) != STATUS_OK)
+                return res;
+            if (memcmp(trailer, cache_trailer, sizeof(cache_trailer)) != 0)
+                return STATUS_CORRUPTED;
+
+            lsp_trace("loaded sample from cache: %s", path.as_native());
+            touch(&path);
+            return STATUS_OK;
+        }
+
+        void SampleCache::touch(const io::Path *path) const
+        {
+            // Rewrite the trailer in place: this updates the modification time which
+            // is used to find least recently used entries
+            io::NativeFile fd;
+            if (fd.open(path, io::File::FM_WRITE) != STATUS_OK)
+                return;
+            lsp_finally { fd.close(); };
+
+            if (fd.seek(-wssize_t(sizeof(cache_trailer)), io::File::FSK_END) != STATUS_OK)
+                return;
+            fd.write(cache_trailer, sizeof(cache_trailer));
+        }
+
+        status_t SampleCache::trim() const
+        {
+            io::Dir dir;
+            status_t res        = dir.open(&sDirectory);
+            if (res != STATUS_OK)
+                return res;
+            lsp_finally { dir.close(); };
+
+            // Collect all entries of the cache
+            lltl::darray<entry_t> entries;
+            wsize_t total       = 0;
+            LSPString name;
+            io::Path path;
+            io::fattr_t attr;
+
+            while ((res = dir.read(&name, false)) == STATUS_OK)
+            {
+                if ((!name.ends_with_ascii(".smp")) || (name.length() >= sizeof(entry_t::sName)))
+                    continue;
+                if ((path.set(&sDirectory) != STATUS_OK) || (path.append_child(&name) != STATUS_OK))
+                    continue;
+                if (io::File::stat(&path, &attr) != STATUS_OK)
+                    continue;
+
+                entry_t *e          = entries.add();
+                if (e == NULL)
+                    return STATUS_NO_MEM;
+                strcpy(e->sName, name.get_utf8());
+                e->nSize            = attr.size;
+                e->nTime            = attr.mtime;
+                total              += attr.size;
+            }
+            if (res != STATUS_EOF)
+                return res;
+            if (total <= nLimit)
+                return STATUS_OK;
+
+            // Remove least recently used entries until the cache fits the limit
+            qsort(entries.array(), entries.size(), sizeof(entry_t), compare_entries);
+            for (size_t i=0, n=entries.size(); (i<n) && (total > nLimit); ++i)
+            {
+                const entry_t *e    = entries.uget(i);
+                if ((path.set(&sDirectory) != STATUS_OK) || (path.append_child(e->sName) != STATUS_OK))
+                    continue;
+                if (path.remove() != STATUS_OK)
+                    continue;
+
+                lsp_trace("removed cache entry: %s", path.as_native());
+                total              -= e->nSize;
+            }
+
+            return STATUS_OK;
+        }
+
+        status_t SampleCache::store(const key_t *key, const dspu::Sample *src, const float * const *thumbs) const
+        {
+            if ((!bEnabled) || (key->nSource == 0))
+                return STATUS_OK;
+
+            io::Path path, tmp;
+            status_t res        = entry_path(&path, key);
+            if (res != STATUS_OK)
+                return res;
+
+            // Write to the unique temporary file first, several instances may render the same sample
+            char suffix[48];
+            const uatomic_t id  = atomic_add(&cache_counter, 1);
+            snprintf(suffix, sizeof(suffix), ".%p.%x.tmp", this, int(id));
+            if ((res = tmp.set(&path)) != STATUS_OK)
+                return res;
+            if ((res = tmp.append(suffix)) != STATUS_OK)
+                return res;
+
+            header_t hdr;
+            memcpy(hdr.vSignature, cache_signature, sizeof(cache_signature));
+            hdr.nVersion        = CACHE_VERSION;
+            hdr.sKey            = *key;
+            hdr.nChannels       = src->channels();
+            hdr.nLength         = src->length();
+
+            io::OutFileStream os;
+            if ((res = os.open(&tmp, io::File::FM_WRITE_NEW)) != STATUS_OK)
+                return res;
+
+            res                 = write_fully(&os, &hdr, sizeof(hdr));
+            for (size_t i=0; (res == STATUS_OK) && (i<hdr.nChannels); ++i)
+                res                 = write_fully(&os, thumbs[i], sizeof(float) * key->nThumbs);
+            for (size_t i=0; (res == STATUS_OK) && (i<hdr.nChannels); ++i)
+                res                 = write_fully(&os, src->channel(i), sizeof(float) * hdr.nLength);
+            if (res == STATUS_OK)
+                res                 = write_fully(&os, cache_trailer, sizeof(cache_trailer));
+
+            const status_t res2 = os.close();
+            if (res == STATUS_OK)
+                res                 = res2;
+
+            // Replace the entry
+            if (res == STATUS_OK)
+                res                 = tmp.rename(&path);
+            if (res != STATUS_OK)
+            {
+                tmp.remove();
+                return res;
+            }
+
+            // Keep the cache within the size limit
+            res                 = trim();
+            if (res != STATUS_OK)
+                lsp_trace("could not trim cache: status=%d (%s)", int(res), get_status(res));
+
+            return STATUS_OK;
+        }
+
+        void SampleCache::dump(dspu::IStateDumper *v) const
+        {
+            v->write("sDirectory", sDirectory.as_native());
+            v->write("nLimit", nLimit);
+            v->write("bEnabled", bEnabled);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/ipc/Thread.h>
+
+#include <private/plugins/sample_resampler.h>
+#include <private/plugins/worker_pool.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        size_t SampleResampler::gcd(size_t a, size_t b)
+        {
+            while (b != 0)
+            {
+                const size_t t  = a % b;
+                a               = b;
+                b               = t;
+            }
+            return a;
+        }
+
+        status_t SampleResampler::process_chunk(job_t *job, const chunk_t *chunk)
+        {
+            const dspu::Sample *src = job->pSrc;
+            dspu::Sample *dst       = job->pDst;
+            const size_t length     = src->length();
+            const size_t channels   = src->channels();
+
+            // Extend the chunk with margins
+            const size_t head       = lsp_min(job->nMargin, chunk->nFirst);
+            const size_t tail       = lsp_min(job->nMargin, length - chunk->nFirst - chunk->nCount);
+            const size_t count      = head + chunk->nCount + tail;
+
+            dspu::Sample temp;
+            if (!temp.init(channels, count, count))
+                return STATUS_NO_MEM;
+            temp.set_sample_rate(job->nSrcRate);
+            for (size_t i=0; i<channels; ++i)
+                dsp::copy(temp.channel(i), &src->channel(i)[chunk->nFirst - head], count);
+
+            status_t res            = temp.resample(job->nDstRate);
+            if (res != STATUS_OK)
+                return res;
+
+            // Chunk boundaries and margins are multiples of the grid step, so positions are exact
+            const size_t first      = (wsize_t(chunk->nFirst) * job->nDstRate) / job->nSrcRate;
+            const size_t last       = lsp_min((wsize_t(chunk->nFirst + chunk->nCount) * job->nDstRate) / job->nSrcRate, wsize_t(dst->length()));
+            const size_t skip       = (wsize_t(head) * job->nDstRate) / job->nSrcRate;
+            if (last <= first)
+                return STATUS_OK;
+
+            const size_t to_do      = last - first;
+            const size_t avail      = (temp.length() > skip) ? temp.length() - skip : 0;
+            const size_t n          = lsp_min(to_do, avail);
+            for (size_t i=0; i<channels; ++i)
+            {
+                float *dptr             = &dst->channel(i)[first];
+                dsp::copy(dptr, &temp.channel(i)[skip], n);
+                dsp::fill_zero(&dptr[n], to_do - n);
+            }
+
+            return STATUS_OK;
+        }
+
+        void SampleResampler::worker(void *arg)
+        {
+            job_t *job              = static_cast<job_t *>(arg);
+            while (atomic_load(&job->nStatus) == uatomic_t(STATUS_OK))
+            {
+                const size_t index      = atomic_add(&job->nNext, 1);
+                if (index >= job->nChunks)
+                    break;
+
+                const status_t res      = process_chunk(job, &job->vChunks[index]);
+                if (res != STATUS_OK)
+                    atomic_cas(&job->nStatus, uatomic_t(STATUS_OK), uatomic_t(res));
+            }
+        }
+
+        status_t SampleResampler::resample_draft(dspu::Sample *dst, const dspu::Sample *src, size_t sample_rate)
+        {
+            const size_t src_rate   = src->sample_rate();
+            const size_t length     = src->length();
+            const size_t channels   = src->channels();
+            const size_t dst_len    = (wsize_t(length) * sample_rate) / src_rate;
+
+            if (!dst->init(channels, dst_len, dst_len))
+                return STATUS_NO_MEM;
+            dst->set_sample_rate(sample_rate);
+            if (length <= 0)
+                return STATUS_OK;
+
+            // Linear interpolation between two nearest source samples
+            const double step       = double(src_rate) / double(sample_rate);
+            for (size_t i=0; i<channels; ++i)
+            {
+                const float *sptr       = src->channel(i);
+                float *dptr             = dst->channel(i);
+                for (size_t j=0; j<dst_len; ++j)
+                {
+                    const double pos        = j * step;
+                    const size_t k          = size_t(pos);
+                    const float s0          = sptr[k];
+                    const float s1          = (k + 1 < length) ? sptr[k + 1] : 0.0f;
+                    dptr[j]                 = s0 + (s1 - s0) * float(pos - k);
+                }
+            }
+
+            return STATUS_OK;
+        }
+
+        status_t SampleResampler::resample(dspu::Sample *dst, const dspu::Sample *src, size_t sample_rate, quality_t quality, size_t threads)
+        {
+            const size_t src_rate   = src->sample_rate();
+            const size_t length     = src->length();
+            const size_t channels   = src->channels();
+
+            if ((quality == Q_DRAFT) && (src_rate > 0) && (sample_rate != src_rate))
+                return resample_draft(dst, src, sample_rate);
+
+            // Compute the step of the grid where positions of source and destination samples match
+            const size_t step       = (src_rate > 0) ? src_rate / gcd(src_rate, sample_rate) : 1;
+            const size_t chunk_min  = CHUNK_MIN * src_rate;
+            const size_t chunk_len  = step * lsp_max(size_t(1), (chunk_min + step - 1) / step);
+            size_t cores            = lsp_min(ipc::Thread::system_cores(), THREADS_MAX);
+            if (threads > 0)
+                cores                   = lsp_min(cores, threads);
+
+            // Short samples are resampled at once
+            if ((src_rate <= 0) || (sample_rate == src_rate) || (cores <= 1) || (length < chunk_len * 2))
+            {
+                status_t res            = dst->copy(src);
+                return (res == STATUS_OK) ? dst->resample(sample_rate) : res;
+            }
+
+            // Compute the overlap of chunks
+            const size_t margin_min = (MARGIN_MIN * src_rate) / lsp_min(src_rate, sample_rate);
+            const size_t margin     = step * ((margin_min + step - 1) / step);
+
+            // Split the sample into chunks
+            const size_t nchunks    = (length + chunk_len - 1) / chunk_len;
+            chunk_t *chunks         = static_cast<chunk_t *>(malloc(sizeof(chunk_t) * nchunks));
+            if (chunks == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { free(chunks); };
+
+            for (size_t i=0; i<nchunks; ++i)
+            {
+                chunks[i].nFirst        = i * chunk_len;
+                chunks[i].nCount        = lsp_min(chunk_len, length - chunks[i].nFirst);
+            }
+
+            // Initialize the destination sample
+            const size_t dst_len    = (wsize_t(length) * sample_rate) / src_rate;
+            if (!dst->init(channels, dst_len, dst_len))
+                return STATUS_NO_MEM;
+            dst->set_sample_rate(sample_rate);
+
+            job_t job;
+            job.pSrc                = src;
+            job.pDst                = dst;
+            job.nSrcRate            = src_rate;
+            job.nDstRate            = sample_rate;
+            job.nMargin             = margin;
+            job.vChunks             = chunks;
+            job.nChunks             = nchunks;
+            job.nNext               = 0;
+            job.nStatus             = STATUS_OK;
+
+            // Process chunks by the current thread and the helper threads available in the process
+            WorkerPool::run(worker, &job, lsp_min(cores, nchunks));
+
+            return status_t(job.nStatus);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/io/File.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/plugins/smf_writer.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        SMFWriter::SMFWriter()
+        {
+            nOffset         = 0;
+        }
+
+        SMFWriter::~SMFWriter()
+        {
+            sOS.close();
+        }
+
+        size_t SMFWriter::varlen_size(uint32_t value)
+        {
+            size_t size     = 1;
+            while (value >= 0x80)
+            {
+                value         >>= 7;
+                ++size;
+            }
+            return size;
+        }
+
+        status_t SMFWriter::flush()
+        {
+            if (nOffset <= 0)
+                return STATUS_OK;
+
+            const ssize_t written   = sOS.write(vBuffer, nOffset);
+            if (written < 0)
+                return status_t(-written);
+            if (size_t(written) != nOffset)
+                return STATUS_IO_ERROR;
+
+            nOffset         = 0;
+            return STATUS_OK;
+        }
+
+        status_t SMFWriter::put(const uint8_t *data, size_t count)
+        {
+            if ((nOffset + count) > BUFFER_SIZE)
+            {
+                status_t res = flush();
+                if (res != STATUS_OK)
+                    return res;
+            }
+
+            memcpy(&vBuffer[nOffset], data, count);
+            nOffset        += count;
+            return STATUS_OK;
+        }
+
+        status_t SMFWriter::put_varlen(uint32_t value)
+        {
+            uint8_t buf[5];
+            const size_t size   = varlen_size(value);
+
+            // The most significant groups go first, all bytes except the last have the continuation bit
+            for (size_t i=size; i > 0; --i)
+            {
+                buf[i-1]            = (value & 0x7f) | ((i < size) ? 0x80 : 0x00);
+                value             >>= 7;
+            }
+
+            return put(buf, size);
+        }
+
+        status_t SMFWriter::open(const char *path, uint16_t division)
+        {
+            nOffset         = 0;
+            status_t res    = sOS.open(path, io::File::FM_WRITE_NEW);
+            if (res != STATUS_OK)
+                return res;
+
+            const uint8_t header[] =
+            {
+                'M', 'T', 'h', 'd',
+                0x00, 0x00, 0x00, 0x06,                         // Header length
+                0x00, 0x00,                                     // Format 0
+                0x00, 0x01,                                     // One track
+                uint8_t(division >> 8), uint8_t(division)       // Ticks per quarter note
+            };
+
+            return put(header, sizeof(header));
+        }
+
+        status_t SMFWriter::begin_track(uint32_t length, uint32_t tempo)
+        {
+            const uint8_t header[] =
+            {
+                'M', 'T', 'r', 'k',
+                uint8_t(length >> 24), uint8_t(length >> 16), uint8_t(length >> 8), uint8_t(length),
+                0x00, 0xff, 0x51, 0x03,                         // Tempo meta event
+                uint8_t(tempo >> 16), uint8_t(tempo >> 8), uint8_t(tempo)
+            };
+
+            return put(header, sizeof(header));
+        }
+
+        status_t SMFWriter::write_event(uint32_t delta, uint8_t status, uint8_t data1, uint8_t data2)
+        {
+            status_t res    = put_varlen(delta);
+            if (res != STATUS_OK)
+                return res;
+
+            const uint8_t event[] = { status, uint8_t(data1 & 0x7f), uint8_t(data2 & 0x7f) };
+            return put(event, sizeof(event));
+        }
+
+        status_t SMFWriter::end_track()
+        {
+            const uint8_t event[] = { 0x00, 0xff, 0x2f, 0x00 };
+            return put(event, sizeof(event));
+        }
+
+        status_t SMFWriter::close()
+        {
+            status_t res    = flush();
+            status_t res2   = sOS.close();
+            return (res != STATUS_OK) ? res : res2;
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
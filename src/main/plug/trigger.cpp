@@ -25,6 +25,9 @@
 #include <lsp-plug.in/dsp/dsp.h>
 #include <lsp-plug.in/dsp-units/units.h>
 #include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/plugins/smf_writer.h>
 
 #include <lsp-plug.in/shared/debug.h>
 #include <lsp-plug.in/shared/id_colors.h>
@@ -73,9 +76,52 @@ namespace lsp
         } /* inline namespace */
 
         //-------------------------------------------------------------------------
+        trigger::MidiExporter::MidiExporter(trigger *core)
+        {
+            pCore       = core;
+        }
+
+        trigger::MidiExporter::~MidiExporter()
+        {
+            pCore       = NULL;
+        }
+
+        status_t trigger::MidiExporter::run()
+        {
+            return pCore->export_midi_file();
+        }
+
+        void trigger::MidiExporter::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pCore", pCore);
+        }
+
+        //-------------------------------------------------------------------------
+        trigger::MidiAllocator::MidiAllocator(trigger *core)
+        {
+            pCore       = core;
+        }
+
+        trigger::MidiAllocator::~MidiAllocator()
+        {
+            pCore       = NULL;
+        }
 
+        status_t trigger::MidiAllocator::run()
+        {
+            return pCore->allocate_midi_records();
+        }
+
+        void trigger::MidiAllocator::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pCore", pCore);
+        }
+
+        //-------------------------------------------------------------------------
         trigger::trigger(const meta::plugin_t *metadata, size_t channels, bool midi):
-            plug::Module(metadata)
+            plug::Module(metadata),
+            sMidiExporter(this),
+            sMidiAllocator(this)
         {
             // Instantiation parameters
             vTmp                = NULL;
@@ -86,6 +132,8 @@ namespace lsp
             // Processors and buffers
             vTimePoints         = NULL;
             vIDisplay           = NULL;
+            for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX + 2; ++i)
+                vIDCoords[i]        = NULL;
 
             // Processing variables
             nCounter            = 0;
@@ -93,6 +141,45 @@ namespace lsp
             fVelocity           = 0.0f;
             bFunctionActive     = true;
             bVelocityActive     = true;
+            nIdleCounter        = 0;
+            nIdleHold           = 0;
+            fIdleLevel          = meta::trigger_metadata::IDLE_LEVEL;
+            nDotSamples         = 1;
+            nDotLeft            = 1;
+            fFunctionDot        = 0.0f;
+            fVelocityDot        = 0.0f;
+            bHistory            = false;
+            bUIActive           = false;
+            bIDisplay           = false;
+            bIDisplayDirty      = true;
+            bIDisplayQuery      = false;
+            fIDisplayRate       = meta::trigger_metadata::IDISPLAY_RATE_DFL;
+            nIDisplayCounter    = 0;
+            nIDisplayPeriod     = 0;
+            nIDisplayWait       = 0;
+            nIDisplayTimeout    = 0;
+            nHistoryDots        = 0;
+            nIDisplayDots       = 0;
+            nIDisplayHeight     = 0;
+            nFunctionSync       = 0;
+            nVelocitySync       = 0;
+            nZoom               = meta::trigger_metadata::HISTORY_ZOOM_DFL;
+            nZoomDots           = 0;
+            nPosition           = 0;
+            nChunkOffset        = 0;
+
+            pExecutor           = NULL;
+            vMidiRecords        = NULL;
+            vMidiAlloc          = NULL;
+            nMidiRecords        = 0;
+            nMidiExport         = 0;
+            nMidiOrigin         = 0;
+            nMidiStatus         = STATUS_UNSPECIFIED;
+            bMidiRecord         = false;
+            bMidiReset          = false;
+            bMidiOverflow       = false;
+            bMidiTruncated      = false;
+            nEventSync          = 0;
 
             // Parameters
             nNote               = meta::trigger_metadata::MIDI_NOTE_DFL + meta::trigger_metadata::MIDI_OCTAVE_DFL * 12;
@@ -102,16 +189,24 @@ namespace lsp
             bPause              = false;
             bClear              = false;
             bUISync             = true;
+            bMeshSync           = false;
+            bCalibrate          = false;
+            nCalibrationCounter = 0;
+            nCalibrationPeriod  = 0;
 
             for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX; ++i)
             {
                 channel_t *c        = &vChannels[i];
 
                 c->vCtl             = NULL;
+                c->fDotLevel        = 0.0f;
+                c->nGraphSync       = 0;
                 c->bVisible         = false;
 
                 c->pIn              = NULL;
                 c->pOut             = NULL;
+                c->pGraph           = NULL;
+                c->pGraphDelta      = NULL;
                 c->pMeter           = NULL;
                 c->pVisible         = NULL;
             }
@@ -129,12 +224,24 @@ namespace lsp
 
             // Control ports
             pFunction           = NULL;
+            pFunctionDelta      = NULL;
             pFunctionLevel      = NULL;
             pFunctionActive     = NULL;
             pVelocity           = NULL;
+            pVelocityDelta      = NULL;
             pVelocityLevel      = NULL;
             pVelocityActive     = NULL;
             pActive             = NULL;
+            pEvents             = NULL;
+            pProfiling          = NULL;
+            for (size_t i=0; i<TriggerProfiler::ST_TOTAL; ++i)
+                pDspLoad[i]         = NULL;
+            pCalibrate          = NULL;
+            pCalDetectLevel     = NULL;
+            pCalReleaseLevel    = NULL;
+            pCalDynaRange1      = NULL;
+            pCalDynaRange2      = NULL;
+            pIDisplayRate       = NULL;
 
             pMidiIn             = NULL;
             pMidiOut            = NULL;
@@ -142,6 +249,9 @@ namespace lsp
             pNote               = NULL;
             pOctave             = NULL;
             pMidiNote           = NULL;
+            pMidiRecord         = NULL;
+            pMidiExportFile     = NULL;
+            pMidiExportStatus   = NULL;
 
             pBypass             = NULL;
             pDry                = NULL;
@@ -150,6 +260,7 @@ namespace lsp
             pGain               = NULL;
             pPause              = NULL;
             pClear              = NULL;
+            pZoom               = NULL;
             pPreamp             = NULL;
             pScHpfMode          = NULL;
             pScHpfFreq          = NULL;
@@ -186,6 +297,22 @@ namespace lsp
             sSidechain.destroy();
             sScEq.destroy();
             sKernel.destroy();
+            for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX; ++i)
+                vChannels[i].sGraph.destroy();
+            sFunction.destroy();
+            sVelocity.destroy();
+
+            // Remove buffer of recorded MIDI events
+            if (vMidiRecords != NULL)
+            {
+                delete [] vMidiRecords;
+                vMidiRecords    = NULL;
+            }
+            if (vMidiAlloc != NULL)
+            {
+                delete [] vMidiAlloc;
+                vMidiAlloc      = NULL;
+            }
 
             // Remove time points buffer
             if (vTimePoints != NULL)
@@ -203,6 +330,9 @@ namespace lsp
             }
 
             vTmp        = NULL;
+            vIDisplay   = NULL;
+            for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX + 2; ++i)
+                vIDCoords[i]    = NULL;
 
             if (pIDisplay != NULL)
             {
@@ -225,6 +355,7 @@ namespace lsp
 
             // Get executor
             ipc::IExecutor *executor = wrapper->executor();
+            pExecutor           = executor;
 
             // Initialize audio channels
             for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX; ++i)
@@ -234,17 +365,21 @@ namespace lsp
                 c->sBypass.construct();
                 c->sGraph.construct();
                 c->vCtl             = NULL;
+                c->fDotLevel        = 0.0f;
+                c->nGraphSync       = 0;
                 c->bVisible         = false;
 
                 c->pIn              = NULL;
                 c->pOut             = NULL;
                 c->pGraph           = NULL;
+                c->pGraphDelta      = NULL;
                 c->pMeter           = NULL;
                 c->pVisible         = NULL;
             }
 
             // Allocate buffer for time coordinates
-            size_t allocate     = meta::trigger_metadata::HISTORY_MESH_SIZE*2 + meta::trigger_metadata::BUFFER_SIZE*3;
+            size_t allocate     = meta::trigger_metadata::HISTORY_MESH_SIZE*(4 + meta::trigger_metadata::TRACKS_MAX) +
+                                  meta::trigger_metadata::BUFFER_SIZE*3;
             float *ctlbuf       = new float[allocate];
             if (ctlbuf == NULL)
                 return;
@@ -252,15 +387,27 @@ namespace lsp
 
             vTimePoints         = advance_ptr<float>(ctlbuf, meta::trigger_metadata::HISTORY_MESH_SIZE);
             vIDisplay           = advance_ptr<float>(ctlbuf, meta::trigger_metadata::HISTORY_MESH_SIZE);
+            for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX + 2; ++i)
+                vIDCoords[i]        = advance_ptr<float>(ctlbuf, meta::trigger_metadata::HISTORY_MESH_SIZE);
             vTmp                = advance_ptr<float>(ctlbuf, meta::trigger_metadata::BUFFER_SIZE);
 
             // Fill time dots with values
-            float step          = meta::trigger_metadata::HISTORY_TIME / meta::trigger_metadata::HISTORY_MESH_SIZE;
-            for (size_t i=0; i < meta::trigger_metadata::HISTORY_MESH_SIZE; ++i)
-                vTimePoints[i]      = (meta::trigger_metadata::HISTORY_MESH_SIZE - i - 1) * step;
+            update_time_points();
+
+            // Initialize history
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                if (!vChannels[i].sGraph.init(meta::trigger_metadata::HISTORY_ZOOM_LEVELS, meta::trigger_metadata::HISTORY_MESH_SIZE))
+                    return;
+            }
+            if (!sFunction.init(meta::trigger_metadata::HISTORY_ZOOM_LEVELS, meta::trigger_metadata::HISTORY_MESH_SIZE))
+                return;
+            if (!sVelocity.init(meta::trigger_metadata::HISTORY_ZOOM_LEVELS, meta::trigger_metadata::HISTORY_MESH_SIZE))
+                return;
 
             // Initialize trigger
             sKernel.init(executor, nFiles, nChannels);
+            sKernel.set_profiler(&sProfiler);
 
             // Now we are ready to bind ports
             size_t port_id          = 0;
@@ -286,6 +433,9 @@ namespace lsp
             for (size_t i=0; i<nChannels; ++i)
                 BIND_PORT(vChannels[i].pGraph);
 
+            for (size_t i=0; i<nChannels; ++i)
+                BIND_PORT(vChannels[i].pGraphDelta);
+
             for (size_t i=0; i<nChannels; ++i)
                 BIND_PORT(vChannels[i].pMeter);
 
@@ -302,6 +452,9 @@ namespace lsp
                 BIND_PORT(pNote);
                 BIND_PORT(pOctave);
                 BIND_PORT(pMidiNote);
+                BIND_PORT(pMidiRecord);
+                BIND_PORT(pMidiExportFile);
+                BIND_PORT(pMidiExportStatus);
             }
 
             // Skip area selector
@@ -320,6 +473,7 @@ namespace lsp
             BIND_PORT(pMode);
             BIND_PORT(pPause);
             BIND_PORT(pClear);
+            BIND_PORT(pZoom);
             BIND_PORT(pPreamp);
             BIND_PORT(pScHpfMode);
             BIND_PORT(pScHpfFreq);
@@ -338,12 +492,31 @@ namespace lsp
 
             lsp_trace("Binding meters...");
             BIND_PORT(pFunction);
+            BIND_PORT(pFunctionDelta);
             BIND_PORT(pFunctionLevel);
             BIND_PORT(pFunctionActive);
             BIND_PORT(pActive);
             BIND_PORT(pVelocity);
+            BIND_PORT(pVelocityDelta);
             BIND_PORT(pVelocityLevel);
             BIND_PORT(pVelocityActive);
+            BIND_PORT(pEvents);
+
+            lsp_trace("Binding profiling ports...");
+            BIND_PORT(pProfiling);
+            for (size_t i=0; i<TriggerProfiler::ST_TOTAL; ++i)
+                BIND_PORT(pDspLoad[i]);
+
+            lsp_trace("Binding calibration ports...");
+            BIND_PORT(pCalibrate);
+            SKIP_PORT("Apply calibration"); // Calibration is applied by the UI
+            BIND_PORT(pCalDetectLevel);
+            BIND_PORT(pCalReleaseLevel);
+            BIND_PORT(pCalDynaRange1);
+            BIND_PORT(pCalDynaRange2);
+
+            lsp_trace("Binding inline display ports...");
+            BIND_PORT(pIDisplayRate);
 
             // Bind kernel
             lsp_trace("Binding kernel ports...");
@@ -362,76 +535,100 @@ namespace lsp
         void trigger::process_samples(const float *sc, size_t samples)
         {
             float max_level     = 0.0f, max_velocity  = 0.0f;
+            size_t dot_left     = (bHistory) ? nDotLeft : samples;
 
-            // Process input data
-            for (size_t i=0; i<samples; ++i)
+            // Process input data split into parts aligned to the history dots
+            for (size_t offset = 0; offset < samples; )
             {
-                // Get sample and log to function
-                float level         = sc[i];
-                if (level > max_level)
-                    max_level           = level;
-                sFunction.process(level);
-
-                // Check trigger state
-                switch (nState)
+                const size_t to_do  = lsp_min(samples - offset, dot_left);
+                float dot_level     = 0.0f, dot_velocity  = 0.0f;
+
+                for (size_t i=offset, end=offset + to_do; i<end; ++i)
                 {
-                    case T_OFF: // Trigger is closed
-                        if (level >= fDetectLevel) // Signal is growing, open trigger
-                        {
-                            // Mark trigger open
-                            nCounter    = nDetectCounter;
-                            nState      = T_DETECT;
-                        }
-                        break;
-                    case T_DETECT:
-                        if (level < fDetectLevel)
-                            nState      = T_OFF;
-                        else if ((nCounter--) <= 0)
-                        {
-                            // Calculate the velocity
-                            fVelocity   = 0.5f * expf(fDynamics * logf(level/fDetectLevel));
-                            float vel   = fVelocity;
-                            if (vel >= fDynaTop) // Saturate to maximum
-                                vel         = 1.0f;
-                            else if (vel <= fDynaBottom) // Saturate to minimum
-                                vel         = 0.0f;
-                            else // Calculate the velocity based on logarithmic scale
-                                vel         = logf(vel/fDynaBottom) / logf(fDynaTop/fDynaBottom);
-
-                            // Trigger state ON
-                            trigger_on(i, vel);
-                            nState      = T_ON;
-
-                            // Indicate that trigger is active
-                            sActive.blink();
-                        }
-                        break;
-                    case T_ON: // Trigger is active
-                        if (level <= fReleaseLevel) // Signal is in peak
-                        {
-                            nCounter    = nReleaseCounter;
-                            nState      = T_RELEASE;
-                        }
-                        break;
-                    case T_RELEASE:
-                        if (level > fReleaseLevel)
-                            nState      = T_ON;
-                        else if ((nCounter--) <= 0)
-                        {
-                            trigger_off(i, 0.0f);
-                            nState      = T_OFF;
-                            fVelocity   = 0.0f;
-                        }
-                        break;
-
-                    default:
-                        break;
+                    // Get sample and log to function
+                    float level         = sc[i];
+                    if (level > dot_level)
+                        dot_level           = level;
+
+                    // Check trigger state
+                    switch (nState)
+                    {
+                        case T_OFF: // Trigger is closed
+                            if (level >= fDetectLevel) // Signal is growing, open trigger
+                            {
+                                // Mark trigger open
+                                nCounter    = nDetectCounter;
+                                nState      = T_DETECT;
+                            }
+                            break;
+                        case T_DETECT:
+                            if (level < fDetectLevel)
+                                nState      = T_OFF;
+                            else if ((nCounter--) <= 0)
+                            {
+                                // Calculate the velocity
+                                fVelocity   = 0.5f * expf(fDynamics * logf(level/fDetectLevel));
+                                float vel   = fVelocity;
+                                if (vel >= fDynaTop) // Saturate to maximum
+                                    vel         = 1.0f;
+                                else if (vel <= fDynaBottom) // Saturate to minimum
+                                    vel         = 0.0f;
+                                else // Calculate the velocity based on logarithmic scale
+                                    vel         = logf(vel/fDynaBottom) / logf(fDynaTop/fDynaBottom);
+
+                                // Trigger state ON
+                                trigger_on(i, vel, level);
+                                nState      = T_ON;
+
+                                // Indicate that trigger is active
+                                sActive.blink();
+                            }
+                            break;
+                        case T_ON: // Trigger is active
+                            if (level <= fReleaseLevel) // Signal is in peak
+                            {
+                                nCounter    = nReleaseCounter;
+                                nState      = T_RELEASE;
+                            }
+                            break;
+                        case T_RELEASE:
+                            if (level > fReleaseLevel)
+                                nState      = T_ON;
+                            else if ((nCounter--) <= 0)
+                            {
+                                trigger_off(i, 0.0f);
+                                nState      = T_OFF;
+                                fVelocity   = 0.0f;
+                            }
+                            break;
+
+                        default:
+                            break;
+                    }
+
+                    // Log the velocity value
+                    if (fVelocity > dot_velocity)
+                        dot_velocity        = fVelocity;
                 }
 
-                // Log the velocity value
-                sVelocity.process(fVelocity);
-                if (fVelocity > max_velocity)
-                    max_velocity        = fVelocity;
+                max_level           = lsp_max(max_level, dot_level);
+                max_velocity        = lsp_max(max_velocity, dot_velocity);
+                offset             += to_do;
+
+                // Update history
+                if (!bHistory)
+                    continue;
+
+                fFunctionDot        = lsp_max(fFunctionDot, dot_level);
+                fVelocityDot        = lsp_max(fVelocityDot, dot_velocity);
+                if ((dot_left -= to_do) <= 0)
+                {
+                    sFunction.process(fFunctionDot);
+                    sVelocity.process(fVelocityDot);
+                    fFunctionDot        = 0.0f;
+                    fVelocityDot        = 0.0f;
+                    dot_left            = nDotSamples;
+                }
             }
 
             // Output meter value
@@ -442,6 +639,93 @@ namespace lsp
             pVelocityLevel->set_value(max_velocity);
         }
 
+        float trigger::measure_input(const float **ins, float *levels, float preamp, size_t samples)
+        {
+            float in_level      = 0.0f;
+
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                const float *in     = ins[i];
+                size_t dot_left     = (bHistory) ? nDotLeft : samples;
+
+                // Compute maximum per each history dot, the maximum of all dots is the level of the input signal
+                for (size_t offset = 0; offset < samples; )
+                {
+                    const size_t to_do  = lsp_min(samples - offset, dot_left);
+                    const float level   = dsp::abs_max(&in[offset], to_do) * preamp;
+                    levels[i]           = lsp_max(levels[i], level);
+                    in_level            = lsp_max(in_level, level);
+                    offset             += to_do;
+
+                    // Update history
+                    if (!bHistory)
+                        continue;
+
+                    c->fDotLevel        = lsp_max(c->fDotLevel, level);
+                    if ((dot_left -= to_do) <= 0)
+                    {
+                        c->sGraph.process(c->fDotLevel);
+                        c->fDotLevel        = 0.0f;
+                        dot_left            = nDotSamples;
+                    }
+                }
+            }
+
+            return in_level;
+        }
+
+        void trigger::update_history_state()
+        {
+            // History is computed only when there is someone to display it
+            const bool history  = (bUIActive) || (bIDisplay);
+            if (history == bHistory)
+                return;
+
+            bHistory            = history;
+            if (!bHistory)
+                return;
+
+            // Drop outdated history
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                c->sGraph.clear();
+                c->fDotLevel        = 0.0f;
+            }
+            sFunction.clear();
+            sVelocity.clear();
+            fFunctionDot        = 0.0f;
+            fVelocityDot        = 0.0f;
+            nDotLeft            = nDotSamples;
+            nHistoryDots       += meta::trigger_metadata::HISTORY_MESH_SIZE;
+        }
+
+        void trigger::advance_history(size_t samples)
+        {
+            if (!bHistory)
+                return;
+
+            if (samples < nDotLeft)
+            {
+                nDotLeft           -= samples;
+                return;
+            }
+
+            samples            -= nDotLeft;
+            nDotLeft            = nDotSamples - samples % nDotSamples;
+
+            // Count new dots of the displayed zoom level
+            const size_t dots   = sFunction.dots(nZoom);
+            if (dots == nZoomDots)
+                return;
+            nHistoryDots       += dots - nZoomDots;
+            nZoomDots           = dots;
+
+            // New dots have been added to the graph
+            if (bIDisplay)
+                bIDisplayDirty      = true;
+        }
 
         size_t trigger::decode_mode()
         {
@@ -485,6 +769,12 @@ namespace lsp
                 nNote       = (pOctave->value() * 12) + pNote->value();
                 nChannel    = pChannel->value();
                 lsp_trace("trigger note=%d, channel=%d", int(nNote), int(nChannel));
+
+                // Restart recording each time it is turned on
+                const bool record   = pMidiRecord->value() >= 0.5f;
+                if ((record) && (!bMidiRecord))
+                    bMidiReset          = true;
+                bMidiRecord     = record;
             }
 
             // Update sidechain settings
@@ -521,7 +811,7 @@ namespace lsp
             fDynamics       = pDynamics->value() * 0.01f; // Percents
             fDynaTop        = pDynaRange1->value();
             fDynaBottom     = pDynaRange2->value();
-
+            fIdleLevel      = lsp_min(meta::trigger_metadata::IDLE_LEVEL, fDetectLevel * 0.5f);
 
             float out_gain  = pGain->value();
             float drywet    = pDryWet->value() * 0.01f;
@@ -529,6 +819,7 @@ namespace lsp
             float wet_gain  = pWet->value();
             fDry            = (dry_gain * drywet + 1.0f - drywet) * out_gain;
             fWet            = wet_gain * drywet * out_gain;
+            sKernel.set_gain(fWet);
 
             bFunctionActive = pFunctionActive->value() >= 0.5f;
             bVelocityActive = pVelocityActive->value() >= 0.5f;
@@ -547,19 +838,51 @@ namespace lsp
 
             // Update sampler settings
             sKernel.update_settings();
+            sProfiler.set_enabled(pProfiling->value() >= 0.5f);
+
+            // Update refresh rate of the inline display
+            fIDisplayRate   = lsp_limit(pIDisplayRate->value(), meta::trigger_metadata::IDISPLAY_RATE_MIN, meta::trigger_metadata::IDISPLAY_RATE_MAX);
+            if (fSampleRate > 0)
+                nIDisplayPeriod = dspu::seconds_to_samples(fSampleRate, 1.0f / fIDisplayRate);
+
+            // Start calibration from scratch each time it is turned on
+            const bool calibrate    = pCalibrate->value() >= 0.5f;
+            if ((calibrate) && (!bCalibrate))
+                sCalibrator.reset();
+            if (calibrate != bCalibrate)
+                nCalibrationCounter = nCalibrationPeriod;
+            bCalibrate      = calibrate;
 
             // Update bypass
             bool bypass     = pBypass->value() >= 0.5f;
             for (size_t i=0; i<nChannels; ++i)
             {
-                if (vChannels[i].sBypass.set_bypass(bypass))
-                    pWrapper->query_display_draw();
+                vChannels[i].sBypass.set_bypass(bypass);
                 vChannels[i].bVisible   = vChannels[i].pVisible->value() >= 0.5f;
             }
 
+            // Thresholds, visibility and bypass affect the inline display
+            bIDisplayDirty  = true;
+
             // Update pause
             bPause          = pPause->value() >= 0.5f;
             bClear          = pClear->value() >= 0.5f;
+            if (bClear)
+            {
+                nHistoryDots   += meta::trigger_metadata::HISTORY_MESH_SIZE;
+                bMeshSync       = true;
+            }
+
+            // Update zoom of the history, the graphs should be completely updated
+            const size_t zoom   = lsp_min(size_t(pZoom->value()), meta::trigger_metadata::HISTORY_ZOOM_LEVELS - 1);
+            if (zoom != nZoom)
+            {
+                nZoom           = zoom;
+                nZoomDots       = sFunction.dots(nZoom);
+                nHistoryDots   += meta::trigger_metadata::HISTORY_MESH_SIZE;
+                bMeshSync       = true;
+                update_time_points();
+            }
 
             // Update counters
             update_counters();
@@ -567,25 +890,41 @@ namespace lsp
 
         void trigger::ui_activated()
         {
-            bUISync = true;
+            bUISync     = true;
+            bUIActive   = true;
             sKernel.sync_samples_with_ui();
         }
 
+        void trigger::ui_deactivated()
+        {
+            bUIActive   = false;
+        }
+
         void trigger::update_sample_rate(long sr)
         {
-            // Calculate number of samples per dot for shift buffer and initialize buffers
-            size_t samples_per_dot  = dspu::seconds_to_samples(sr,
-                    meta::trigger_metadata::HISTORY_TIME / meta::trigger_metadata::HISTORY_MESH_SIZE
-                );
+            // Calculate number of samples per dot of the most detailed zoom level, graphs receive already reduced dots
+            nDotSamples             = lsp_max(dspu::seconds_to_samples(sr,
+                    meta::trigger_metadata::HISTORY_TIME /
+                    (meta::trigger_metadata::HISTORY_MESH_SIZE << meta::trigger_metadata::HISTORY_ZOOM_DFL)
+                ), size_t(1));
+            nDotLeft                = nDotSamples;
+            fFunctionDot            = 0.0f;
+            fVelocityDot            = 0.0f;
+
+            sCalibrator.set_sample_rate(sr);
+            nCalibrationPeriod      = dspu::seconds_to_samples(sr, 1.0f / meta::trigger_metadata::CALIBRATION_RATE);
+            nCalibrationCounter     = nCalibrationPeriod;
 
             // Update sample rate for bypass
             for (size_t i=0; i<nChannels; ++i)
             {
                 vChannels[i].sBypass.init(sr);
-                vChannels[i].sGraph.init(meta::trigger_metadata::HISTORY_MESH_SIZE, samples_per_dot);
+                vChannels[i].sGraph.clear();
+                vChannels[i].fDotLevel  = 0.0f;
             }
-            sFunction.init(meta::trigger_metadata::HISTORY_MESH_SIZE, samples_per_dot);
-            sVelocity.init(meta::trigger_metadata::HISTORY_MESH_SIZE, samples_per_dot);
+            sFunction.clear();
+            sVelocity.clear();
+            nHistoryDots           += meta::trigger_metadata::HISTORY_MESH_SIZE;
 
             // Update settings on all samplers
             sKernel.update_sample_rate(sr);
@@ -597,11 +936,21 @@ namespace lsp
             // Update activity blink
             sActive.init(sr);
 
+            // Update idle detector
+            nIdleCounter            = 0;
+            nIdleHold               = dspu::millis_to_samples(sr, meta::trigger_metadata::IDLE_HOLD_TIME);
+
+            // Update inline display refresh period
+            nIDisplayPeriod         = dspu::seconds_to_samples(sr, 1.0f / fIDisplayRate);
+            nIDisplayTimeout        = dspu::seconds_to_samples(sr, meta::trigger_metadata::IDISPLAY_TIMEOUT);
+            nIDisplayCounter        = nIDisplayTimeout;
+            nIDisplayWait           = 0;
+
             // Update counters
             update_counters();
         }
 
-        void trigger::trigger_on(size_t timestamp, float level)
+        void trigger::trigger_on(size_t timestamp, float level, float sc_level)
         {
             if (pMidiOut != NULL)
             {
@@ -611,7 +960,7 @@ namespace lsp
                 {
                     // Create event
                     midi::event_t ev;
-                    ev.timestamp    = timestamp;
+                    ev.timestamp    = nChunkOffset + timestamp;
                     ev.type         = midi::MIDI_MSG_NOTE_ON;
                     ev.channel      = nChannel;
                     ev.note.pitch   = nNote;
@@ -622,8 +971,18 @@ namespace lsp
                 }
             }
 
-            // Handle Note On event
-            sKernel.trigger_on(timestamp, level);
+            record_midi_event(timestamp, midi::MIDI_MSG_NOTE_ON, uint8_t(1 + (level * 126)));
+
+            // Handle Note On event and log it
+            trigger_event_t *ev = sEvents.begin();
+            ev->nTimestamp      = nPosition + timestamp;
+            ev->fLevel          = sc_level;
+            ev->fVelocity       = level;
+            ev->nFile           = -1;
+            ev->nDelay          = 0;
+
+            sKernel.trigger_on(timestamp, level, ev);
+            sEvents.commit();
         }
 
         void trigger::trigger_off(size_t timestamp, float level)
@@ -636,7 +995,7 @@ namespace lsp
                 {
                     // Create event
                     midi::event_t ev;
-                    ev.timestamp    = timestamp;
+                    ev.timestamp    = nChunkOffset + timestamp;
                     ev.type         = midi::MIDI_MSG_NOTE_OFF;
                     ev.channel      = nChannel;
                     ev.note.pitch   = nNote;
@@ -647,12 +1006,16 @@ namespace lsp
                 }
             }
 
+            record_midi_event(timestamp, midi::MIDI_MSG_NOTE_OFF, 0);
+
             // Do ont handle Note Off event by sampler because it will cause it to stop sample playback
             // sKernel.trigger_off(timestamp, level);
         }
 
         void trigger::process(size_t samples)
         {
+            sProfiler.begin();
+
             // Bypass MIDI events (additionally to the triggered events)
             if ((pMidiIn != NULL) && (pMidiOut != NULL))
             {
@@ -672,156 +1035,516 @@ namespace lsp
             const float *ins[meta::trigger_metadata::TRACKS_MAX];
             float *outs[meta::trigger_metadata::TRACKS_MAX];
             float *ctls[meta::trigger_metadata::TRACKS_MAX];
-            float preamp        = sSidechain.get_gain();
+            float levels[meta::trigger_metadata::TRACKS_MAX];
+            const float preamp  = sSidechain.get_gain();
 
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c        = &vChannels[i];
                 ins[i]              = (c->pIn != NULL)  ? c->pIn->buffer<float>() : NULL;
                 outs[i]             = (c->pOut != NULL) ? c->pOut->buffer<float>() : NULL;
-
-                // Update meter
-                if ((ins[i] != NULL) && (c->pMeter != NULL))
-                {
-                    float level         = dsp::abs_max(ins[i], samples) * preamp;
-                    c->pMeter->set_value(level);
-                }
+                ctls[i]             = c->vCtl;
+                levels[i]           = 0.0f;
             }
             pReleaseValue->set_value(fReleaseLevel);
+            update_history_state();
 
             // Process samples
             for (size_t offset = 0; offset < samples; )
             {
                 // Calculate amount of samples to process
                 const size_t to_process = lsp_min(samples - offset, meta::trigger_metadata::BUFFER_SIZE);
+                nChunkOffset            = offset;
+
+                // Measure the input level and feed input graphs while the data is still hot in the cache
+                const float in_level    = measure_input(ins, levels, preamp, to_process);
+                sProfiler.end(TriggerProfiler::ST_DETECTOR);
+
+                // Check whether the trigger may fall asleep: silent input, no voices and no pending events,
+                // calibration needs the trigger function for the whole signal including the silence
+                if ((in_level < fIdleLevel) && (nState == T_OFF) && (!bCalibrate) && (sKernel.idle()))
+                    nIdleCounter        = lsp_min(nIdleCounter + to_process, nIdleHold);
+                else
+                    nIdleCounter        = 0;
+
+                if (nIdleCounter >= nIdleHold)
+                    process_idle(outs, ins, to_process);
+                else
+                {
+                    // Now we have to process data
+                    sSidechain.process(vTmp, ins, to_process);  // Pass input to sidechain
+                    sProfiler.end(TriggerProfiler::ST_SIDECHAIN);
+                    process_samples(vTmp, to_process);          // Pass sidechain output for sample processing
+                    if (bCalibrate)
+                        sCalibrator.process(vTmp, to_process);
+                    sProfiler.end(TriggerProfiler::ST_DETECTOR);
+
+                    // Put the dry signal to the control chain and let the kernel mix the wet signal on top of it
+                    for (size_t i=0; i<nChannels; ++i)
+                        dsp::mul_k3(ctls[i], ins[i], fDry, to_process);
+                    sProfiler.end(TriggerProfiler::ST_OUTPUT);
+                    sKernel.process(ctls, const_cast<const float **>(ctls), to_process);
+
+                    // Pass the mix thru bypass switch
+                    for (size_t i=0; i<nChannels; ++i)
+                        vChannels[i].sBypass.process(outs[i], ins[i], ctls[i], to_process);
+                    sProfiler.end(TriggerProfiler::ST_OUTPUT);
+                }
 
-                // Prepare the control chain
+                // Update pointers
                 for (size_t i=0; i<nChannels; ++i)
                 {
-                    channel_t *c        = &vChannels[i];
-                    ctls[i]             = c->vCtl;
-                    dsp::mul_k3(ctls[i], ins[i], preamp, to_process);
-                    c->sGraph.process(ctls[i], samples);
+                    ins[i]         += to_process;
+                    outs[i]        += to_process;
                 }
+                offset         += to_process;
+                nPosition      += to_process;
+                advance_history(to_process);
+            }
 
-                // Now we have to process data
-                sSidechain.process(vTmp, ins, to_process);  // Pass input to sidechain
-                process_samples(vTmp, to_process);          // Pass sidechain output for sample processing
+            // Output meter values
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                if (c->pMeter != NULL)
+                    c->pMeter->set_value(levels[i]);
+            }
 
-                // Call sampler kernel for processing
-                sKernel.process(ctls, NULL, to_process);
+            if ((!bPause) || (bClear) || (bUISync))
+            {
+                // Force complete transfer of all graphs if UI requires synchronization
+                if (bUISync)
+                {
+                    const size_t sync   = nHistoryDots - meta::trigger_metadata::HISTORY_MESH_SIZE;
+                    for (size_t i=0; i<nChannels; ++i)
+                        vChannels[i].nGraphSync = sync;
+                    nFunctionSync       = sync;
+                    nVelocitySync       = sync;
+                    bMeshSync           = true;
+                }
 
-                // Now mix dry/wet signals and pass thru bypass switch
-                for (size_t i=0; i<nChannels; ++i)
+                // Clear data if requested
+                if (bClear)
                 {
-                    dsp::mix2(ctls[i], ins[i], fWet, fDry, to_process);
-                    vChannels[i].sBypass.process(outs[i], ins[i], ctls[i], to_process);
+                    for (size_t i=0; i<nChannels; ++i)
+                        vChannels[i].sGraph.clear();
+                    sFunction.clear();
+                    sVelocity.clear();
                 }
 
-                // Update pointers
+                // Transfer new dots of the history
                 for (size_t i=0; i<nChannels; ++i)
                 {
-                    ins[i]         += to_process;
-                    outs[i]        += to_process;
+                    channel_t *c        = &vChannels[i];
+                    sync_history_mesh(c->pGraphDelta, &c->sGraph, &c->nGraphSync);
                 }
-                offset         += to_process;
+                sync_history_mesh(pFunctionDelta, &sFunction, &nFunctionSync);
+                sync_history_mesh(pVelocityDelta, &sVelocity, &nVelocitySync);
+
+                bUISync = false;
             }
 
-            if ((!bPause) || (bClear) || (bUISync))
+            // Complete meshes are transferred only when resynchronization is requested,
+            // the request is kept until all of them have been taken by the consumer
+            if (bMeshSync)
             {
-                // Process mesh requests
+                bool done           = true;
                 for (size_t i=0; i<nChannels; ++i)
                 {
-                    // Get channel
                     channel_t *c        = &vChannels[i];
-                    if (c->pGraph == NULL)
-                        continue;
+                    done                = fill_history_mesh(c->pGraph, &c->sGraph, G_INPUT) && done;
+                }
+                done                = fill_history_mesh(pFunction, &sFunction, G_FUNCTION) && done;
+                done                = fill_history_mesh(pVelocity, &sVelocity, G_VELOCITY) && done;
+                bMeshSync           = !done;
+            }
 
-                    // Clear data if requested
-                    if (bClear)
-                        c->sGraph.clear();
+            // Transfer new trigger events
+            sync_event_log();
+            process_midi_export();
 
-                    // Get mesh
-                    plug::mesh_t *mesh  = c->pGraph->buffer<plug::mesh_t>();
-                    if ((mesh != NULL) && (mesh->isEmpty()))
-                    {
-                        float *x = mesh->pvData[0];
-                        float *y = mesh->pvData[1];
+            // Output calibrated thresholds
+            output_calibration(samples);
+
+            // Account the transfer of analysis data to the detector and output the load of processing stages
+            sProfiler.end(TriggerProfiler::ST_DETECTOR);
+            sProfiler.commit(samples);
+            output_dsp_load(samples);
+
+            // The inline display is considered hidden if the host does not answer redraw requests,
+            // the history is not computed for it anymore
+            if (bIDisplayQuery)
+            {
+                nIDisplayWait      += samples;
+                if (nIDisplayWait >= nIDisplayTimeout)
+                {
+                    bIDisplay           = false;
+                    bIDisplayQuery      = false;
+                }
+            }
+
+            // Query for drawing only if there are changes and not often than the refresh rate.
+            // The hidden inline display is queried once per timeout to detect that it is shown again
+            const size_t period = (bIDisplay) ? nIDisplayPeriod : nIDisplayTimeout;
+            nIDisplayCounter    = lsp_min(nIDisplayCounter + samples, nIDisplayTimeout);
+            if (((bIDisplayDirty) || (!bIDisplay)) && (nIDisplayCounter >= period))
+            {
+                pWrapper->query_display_draw();
+                bIDisplayDirty      = false;
+                nIDisplayCounter    = 0;
+                if (!bIDisplayQuery)
+                {
+                    bIDisplayQuery      = true;
+                    nIDisplayWait       = 0;
+                }
+            }
+        }
+
+        float trigger::history_time() const
+        {
+            // Each zoom level doubles the time window of the previous one
+            return ldexpf(meta::trigger_metadata::HISTORY_TIME, int(nZoom) - int(meta::trigger_metadata::HISTORY_ZOOM_DFL));
+        }
 
-                        // Fill mesh with new values
-                        dsp::copy(&x[1], vTimePoints, meta::trigger_metadata::HISTORY_MESH_SIZE);
-                        c->sGraph.read(&y[1], meta::trigger_metadata::HISTORY_MESH_SIZE);
+        void trigger::update_time_points()
+        {
+            if (vTimePoints == NULL)
+                return;
+
+            const float step    = history_time() / meta::trigger_metadata::HISTORY_MESH_SIZE;
+            for (size_t i=0; i < meta::trigger_metadata::HISTORY_MESH_SIZE; ++i)
+                vTimePoints[i]      = (meta::trigger_metadata::HISTORY_MESH_SIZE - i - 1) * step;
+        }
+
+        bool trigger::fill_history_mesh(plug::IPort *port, const HistoryPyramid *graph, graph_t type)
+        {
+            if (port == NULL)
+                return true;
+            plug::mesh_t *mesh  = port->buffer<plug::mesh_t>();
+            if (mesh == NULL)
+                return true;
+            if (!mesh->isEmpty())
+                return false;
 
-                        x[0] = x[1];
-                        y[0] = 0.0f;
+            // Complete mesh for hosts and external consumers, the skip leaves room for the edge points
+            const size_t count  = meta::trigger_metadata::HISTORY_MESH_SIZE;
+            const size_t skip   = (type == G_INPUT) ? 1 : (type == G_VELOCITY) ? 2 : 0;
+            float *x            = mesh->pvData[0];
+            float *y            = mesh->pvData[1];
 
-                        x[meta::trigger_metadata::HISTORY_MESH_SIZE + 1] = x[meta::trigger_metadata::HISTORY_MESH_SIZE];
-                        y[meta::trigger_metadata::HISTORY_MESH_SIZE + 1] = 0.0f;
+            dsp::copy(&x[skip], vTimePoints, count);
+            graph->read(nZoom, &y[skip], count);
 
-                        mesh->data(2, meta::trigger_metadata::HISTORY_MESH_SIZE + 2);
+            switch (type)
+            {
+                case G_INPUT:
+                    x[0]                = x[1];
+                    y[0]                = 0.0f;
+                    x[count + 1]        = x[count];
+                    y[count + 1]        = 0.0f;
+                    mesh->data(2, count + 2);
+                    break;
+
+                case G_VELOCITY:
+                    x[0]                = x[2] + 0.5f;
+                    x[1]                = x[0];
+                    y[0]                = 0.0f;
+                    y[1]                = y[2];
+
+                    x                  += count + 2;
+                    y                  += count + 2;
+
+                    x[0]                = x[-1] - 0.5f;
+                    y[0]                = y[-1];
+                    x[1]                = x[0];
+                    y[1]                = 0.0f;
+                    mesh->data(2, count + 4);
+                    break;
+
+                default:
+                    mesh->data(2, count);
+                    break;
+            }
+
+            return true;
+        }
+
+        void trigger::sync_history_mesh(plug::IPort *port, const HistoryPyramid *graph, size_t *sync)
+        {
+            if (port == NULL)
+                return;
+            plug::mesh_t *mesh  = port->buffer<plug::mesh_t>();
+            if ((mesh == NULL) || (!mesh->isEmpty()))
+                return;
+
+            // Transfer only dots added since the last transfer, the UI keeps the copy of the history
+            const size_t dots   = nHistoryDots;
+            const size_t count  = lsp_min(dots - *sync, meta::trigger_metadata::HISTORY_MESH_SIZE);
+            if (count == 0)
+                return;
+
+            // First buffer contains values of dots, second buffer contains positions of dots in the ring
+            float *v            = mesh->pvData[0];
+            float *p            = mesh->pvData[1];
+            graph->read(nZoom, v, count);
+            for (size_t i=0, pos = dots - count; i<count; ++i, ++pos)
+                p[i]                = pos % meta::trigger_metadata::HISTORY_MESH_SIZE;
+
+            mesh->data(2, count);
+            *sync               = dots;
+        }
+
+        void trigger::sync_event_log()
+        {
+            if (pEvents == NULL)
+                return;
+            plug::mesh_t *mesh  = pEvents->buffer<plug::mesh_t>();
+            if ((mesh == NULL) || (!mesh->isEmpty()))
+                return;
+
+            // Transfer only events that have been logged since the last transfer
+            const uatomic_t head    = sEvents.head();
+            const uatomic_t avail   = meta::trigger_metadata::EVENT_LOG_SIZE - 1;
+            if (uatomic_t(head - nEventSync) > avail)
+                nEventSync              = head - avail;
+
+            size_t count            = 0;
+            for (uatomic_t index = nEventSync; index != head; ++index)
+            {
+                trigger_event_t ev;
+                if (!sEvents.get(&ev, index))
+                    continue;
+
+                // Timestamp is transferred as the age of the event to keep the precision
+                mesh->pvData[0][count]  = nPosition - ev.nTimestamp;
+                mesh->pvData[1][count]  = ev.fLevel;
+                mesh->pvData[2][count]  = ev.fVelocity;
+                mesh->pvData[3][count]  = ev.nFile;
+                mesh->pvData[4][count]  = dspu::samples_to_millis(fSampleRate, ev.nDelay);
+                ++count;
+            }
+            nEventSync              = head;
+
+            if (count > 0)
+                mesh->data(5, count);
+        }
+
+        void trigger::record_midi_event(size_t timestamp, uint8_t status, uint8_t velocity)
+        {
+            if ((!bMidiRecord) || (bMidiReset) || (vMidiRecords == NULL))
+                return;
+            if (nMidiRecords >= meta::trigger_metadata::MIDI_RECORD_MAX)
+            {
+                // Report that the recording is truncated unless the export is in progress
+                if ((!bMidiOverflow) && (sMidiExporter.idle()))
+                    nMidiStatus         = STATUS_OVERFLOW;
+                bMidiOverflow       = true;
+                return;
+            }
+
+            midi_record_t *r    = &vMidiRecords[nMidiRecords++];
+            r->nTime            = nPosition + timestamp;
+            r->nStatus          = status | (nChannel & 0x0f);
+            r->nNote            = nNote;
+            r->nVelocity        = velocity;
+        }
+
+        void trigger::process_midi_export()
+        {
+            if (pMidiExportFile == NULL)
+                return;
+
+            // The buffer for recorded events is allocated by the executor when the recording
+            // is turned on for the first time, the audio thread never allocates memory
+            if ((bMidiRecord) && (vMidiRecords == NULL))
+            {
+                if (sMidiAllocator.idle())
+                    pExecutor->submit(&sMidiAllocator);
+                else if (sMidiAllocator.completed())
+                {
+                    if (sMidiAllocator.code() == STATUS_OK)
+                    {
+                        vMidiRecords        = vMidiAlloc;
+                        vMidiAlloc          = NULL;
                     }
+                    else
+                        nMidiStatus         = sMidiAllocator.code();
+                    sMidiAllocator.reset();
                 }
+            }
 
-                // Trigger function
-                if (pFunction != NULL)
-                {
-                    // Clear data if requested
-                    if (bClear)
-                        sFunction.clear();
+            // Restart recording only when the export task does not read the recorded events
+            if ((bMidiReset) && (vMidiRecords != NULL) && (sMidiExporter.idle()))
+            {
+                nMidiRecords        = 0;
+                nMidiOrigin         = nPosition;
+                bMidiReset          = false;
+                bMidiOverflow       = false;
+            }
 
-                    // Fill mesh if needed
-                    plug::mesh_t *mesh = pFunction->buffer<plug::mesh_t>();
-                    if ((mesh != NULL) && (mesh->isEmpty()))
+            plug::path_t *path  = pMidiExportFile->buffer<plug::path_t>();
+            if (path != NULL)
+            {
+                if ((path->pending()) && (sMidiExporter.idle()))
+                {
+                    // Export all events recorded at this moment, the recording may continue while exporting
+                    nMidiExport         = nMidiRecords;
+                    bMidiTruncated      = bMidiOverflow;
+                    if (pExecutor->submit(&sMidiExporter))
                     {
-                        dsp::copy(mesh->pvData[0], vTimePoints, meta::trigger_metadata::HISTORY_MESH_SIZE);
-                        sFunction.read(mesh->pvData[1], meta::trigger_metadata::HISTORY_MESH_SIZE);
-                        mesh->data(2, meta::trigger_metadata::HISTORY_MESH_SIZE);
+                        nMidiStatus         = STATUS_IN_PROCESS;
+                        path->accept();
                     }
                 }
-
-                // Trigger velocity
-                if (pVelocity != NULL)
+                else if ((path->accepted()) && (sMidiExporter.completed()))
                 {
-                    // Clear data if requested
-                    if (bClear)
-                        sVelocity.clear();
+                    nMidiStatus         = sMidiExporter.code();
+                    if ((nMidiStatus == STATUS_OK) && (bMidiTruncated))
+                        nMidiStatus         = STATUS_OVERFLOW;
+                    path->commit();
+                    sMidiExporter.reset();
+                }
+            }
 
-                    // Fill mesh if needed
-                    plug::mesh_t *mesh = pVelocity->buffer<plug::mesh_t>();
-                    if ((mesh != NULL) && (mesh->isEmpty()))
-                    {
-                        float *x = mesh->pvData[0];
-                        float *y = mesh->pvData[1];
+            pMidiExportStatus->set_value(nMidiStatus);
+        }
+
+        status_t trigger::export_midi_file()
+        {
+            plug::path_t *path      = pMidiExportFile->buffer<plug::path_t>();
+            if (path == NULL)
+                return STATUS_UNKNOWN_ERR;
+
+            const char *fname       = path->path();
+            if (strlen(fname) <= 0)
+                return STATUS_UNSPECIFIED;
+
+            // Compute the position of each event in ticks and the length of the track
+            const size_t count      = nMidiExport;
+            const double k          = (double(meta::trigger_metadata::SMF_DIVISION) * 1e+6) /
+                                      (double(meta::trigger_metadata::SMF_TEMPO) * fSampleRate);
+            size_t length           = SMFWriter::empty_track_size();
+            wsize_t prev            = 0;
+            for (size_t i=0; i<count; ++i)
+            {
+                const wsize_t tick      = (vMidiRecords[i].nTime - nMidiOrigin) * k;
+                length                 += SMFWriter::event_size(lsp_min(tick - prev, wsize_t(0x0fffffff)));
+                prev                    = tick;
+            }
 
-                        dsp::copy(&x[2], vTimePoints, meta::trigger_metadata::HISTORY_MESH_SIZE);
-                        sVelocity.read(&y[2], meta::trigger_metadata::HISTORY_MESH_SIZE);
+            // Write the file
+            SMFWriter w;
+            status_t res            = w.open(fname, meta::trigger_metadata::SMF_DIVISION);
+            if (res == STATUS_OK)
+                res                     = w.begin_track(length, meta::trigger_metadata::SMF_TEMPO);
 
-                        x[0] = x[2] + 0.5f;
-                        x[1] = x[0];
-                        y[0] = 0.0f;
-                        y[1] = y[2];
+            prev                    = 0;
+            for (size_t i=0; (res == STATUS_OK) && (i<count); ++i)
+            {
+                const midi_record_t *r  = &vMidiRecords[i];
+                const wsize_t tick      = (r->nTime - nMidiOrigin) * k;
+                res                     = w.write_event(lsp_min(tick - prev, wsize_t(0x0fffffff)), r->nStatus, r->nNote, r->nVelocity);
+                prev                    = tick;
+            }
 
-                        x += meta::trigger_metadata::HISTORY_MESH_SIZE + 2;
-                        y += meta::trigger_metadata::HISTORY_MESH_SIZE + 2;
+            if (res == STATUS_OK)
+                res                     = w.end_track();
 
-                        x[0] = x[-1] - 0.5f;
-                        y[0] = y[-1];
-                        x[1] = x[0];
-                        y[1] = 0.0f;
+            const status_t res2     = w.close();
+            return (res != STATUS_OK) ? res : res2;
+        }
 
-                        mesh->data(2, meta::trigger_metadata::HISTORY_MESH_SIZE + 4);
-                    }
+        status_t trigger::allocate_midi_records()
+        {
+            vMidiAlloc              = new midi_record_t[meta::trigger_metadata::MIDI_RECORD_MAX];
+            return (vMidiAlloc != NULL) ? STATUS_OK : STATUS_NO_MEM;
+        }
+
+        void trigger::output_calibration(size_t samples)
+        {
+            // Analysis of the statistics is expensive, there is no need to do it more often than the UI refreshes
+            nCalibrationCounter = lsp_min(nCalibrationCounter + samples, nCalibrationPeriod);
+            if (nCalibrationCounter < nCalibrationPeriod)
+                return;
+            nCalibrationCounter = 0;
+
+            // Output current settings if there is no statistics
+            calibration_t cal;
+            if ((!bCalibrate) || (!sCalibrator.analyze(&cal, fDynamics)))
+            {
+                cal.fDetectLevel    = fDetectLevel;
+                cal.fReleaseLevel   = pReleaseLevel->value();
+                cal.fDynaTop        = fDynaTop;
+                cal.fDynaBottom     = fDynaBottom;
+            }
+
+            pCalDetectLevel->set_value(cal.fDetectLevel);
+            pCalReleaseLevel->set_value(cal.fReleaseLevel);
+            pCalDynaRange1->set_value(cal.fDynaTop);
+            pCalDynaRange2->set_value(cal.fDynaBottom);
+        }
+
+        void trigger::output_dsp_load(size_t samples)
+        {
+            if (!sProfiler.enabled())
+            {
+                for (size_t i=0; i<TriggerProfiler::ST_TOTAL; ++i)
+                    pDspLoad[i]->set_value(0.0f);
+                return;
+            }
+
+            // Compute the load as a percentage of the block duration
+            const float k       = (samples > 0) ? 1e-7f * fSampleRate / samples : 0.0f;
+            for (size_t i=0; i<TriggerProfiler::ST_TOTAL; ++i)
+            {
+                const float load    = sProfiler.last(TriggerProfiler::stage_t(i)) * k;
+                pDspLoad[i]->set_value(lsp_min(load, meta::trigger_metadata::DSP_LOAD_MAX));
+            }
+        }
+
+        void trigger::process_idle(float **outs, const float **ins, size_t samples)
+        {
+            // Keep the sidechain running: the state of its filters and envelope should follow the
+            // input, otherwise the first hit after the sleep is detected with the outdated state
+            sSidechain.process(vTmp, ins, samples);
+            sProfiler.end(TriggerProfiler::ST_SIDECHAIN);
+
+            // Keep function and velocity graphs running with silence
+            if (bHistory)
+            {
+                for (size_t dot_left = nDotLeft; dot_left <= samples; dot_left += nDotSamples)
+                {
+                    sFunction.process(fFunctionDot);
+                    sVelocity.process(fVelocityDot);
+                    fFunctionDot        = 0.0f;
+                    fVelocityDot        = 0.0f;
                 }
+            }
 
-                bUISync = false;
+            // Output the dry signal only and pass thru bypass switch
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                dsp::mul_k3(outs[i], ins[i], fDry, samples);
+                vChannels[i].sBypass.process(outs[i], ins[i], outs[i], samples);
             }
+            sProfiler.end(TriggerProfiler::ST_OUTPUT);
+
+            // Perform background tasks of the kernel
+            sKernel.process_idle(samples);
 
-            // Always query for draawing
-            pWrapper->query_display_draw();
+            // Output meter values
+            if (pActive != NULL)
+                pActive->set_value(sActive.process(samples));
+            pFunctionLevel->set_value(0.0f);
+            pVelocityLevel->set_value(0.0f);
         }
 
         bool trigger::inline_display(plug::ICanvas *cv, size_t width, size_t height)
         {
+            // Request the history to be computed
+            bIDisplay       = true;
+            bIDisplayQuery  = false;
+
             // Check proportions
             if (height > (M_RGOLD_RATIO * width))
                 height  = M_RGOLD_RATIO * width;
@@ -837,17 +1560,19 @@ namespace lsp
             cv->set_color_rgb((bypassing) ? CV_DISABLED : CV_BACKGROUND);
             cv->paint();
 
-            // Calc axis params
+            // Calc axis params, the time window depends on the zoom
+            float time  = history_time();
+            float tstep = time / meta::trigger_metadata::HISTORY_TIME;
             float zy    = 1.0f/GAIN_AMP_M_72_DB;
-            float dx    = -float(width/meta::trigger_metadata::HISTORY_TIME);
+            float dx    = -float(width/time);
             float dy    = height/(logf(GAIN_AMP_M_72_DB)-logf(GAIN_AMP_P_24_DB));
 
             // Draw axis
             cv->set_line_width(1.0);
 
-            // Draw vertical lines
+            // Draw vertical lines: 1 second for the default zoom, scaled together with the time window
             cv->set_color_rgb(CV_YELLOW, 0.5f);
-            for (float i=1.0; i < (meta::trigger_metadata::HISTORY_TIME-0.1f); i += 1.0f)
+            for (float i=tstep; i < (time - 0.1f*tstep); i += tstep)
             {
                 float ax = width + dx*i;
                 cv->line(ax, 0, ax, height);
@@ -861,25 +1586,54 @@ namespace lsp
                 cv->line(0, ay, width, ay);
             }
 
-            // Allocate buffer: t, f1(t), x, y
-            pIDisplay           = core::IDBuffer::reuse(pIDisplay, 4, width);
+            // Allocate buffer: x, y
+            pIDisplay           = core::IDBuffer::reuse(pIDisplay, 2, width);
             core::IDBuffer *b   = pIDisplay;
             if (b == NULL)
                 return false;
 
+            // Update cached coordinates of history dots: shift previously computed
+            // coordinates and compute coordinates only for the new dots
+            const HistoryPyramid *graphs[meta::trigger_metadata::TRACKS_MAX + 2];
+            for (size_t i=0; i<nChannels; ++i)
+                graphs[i]           = &vChannels[i].sGraph;
+            graphs[nChannels]   = &sFunction;
+            graphs[nChannels+1] = &sVelocity;
+
+            const size_t dots   = nHistoryDots;
+            size_t shift        = dots - nIDisplayDots;
+            if ((height != nIDisplayHeight) || (shift > meta::trigger_metadata::HISTORY_MESH_SIZE))
+                shift               = meta::trigger_metadata::HISTORY_MESH_SIZE;
+
+            if (shift > 0)
+            {
+                const size_t first  = meta::trigger_metadata::HISTORY_MESH_SIZE - shift;
+                for (size_t i=0; i<nChannels+2; ++i)
+                {
+                    float *ys           = vIDCoords[i];
+                    dsp::move(ys, &ys[shift], first);
+                    graphs[i]->read(nZoom, &vIDisplay[first], shift);
+                    dsp::fill(&ys[first], height, shift);
+                    dsp::axis_apply_log1(&ys[first], &vIDisplay[first], zy, dy, shift);
+                }
+            }
+
+            // Force full update on the next draw if history has been changed while reading
+            nIDisplayDots       = (dots == nHistoryDots) ? dots : dots - meta::trigger_metadata::HISTORY_MESH_SIZE;
+            nIDisplayHeight     = height;
+
+            // Compute horizontal coordinates
+            bool bypass         = vChannels[0].sBypass.bypassing();
+            float r             = meta::trigger_metadata::HISTORY_MESH_SIZE / float(width);
+
+            for (size_t j=0; j<width; ++j)
+                b->v[0][j]          = width + dx * vTimePoints[size_t(r*j)];
+
             // Draw input signal
             static uint32_t c_colors[] = {
                     CV_MIDDLE_CHANNEL, CV_MIDDLE_CHANNEL,
                     CV_LEFT_CHANNEL, CV_RIGHT_CHANNEL
                    };
-            bool bypass         = vChannels[0].sBypass.bypassing();
-            float r             = meta::trigger_metadata::HISTORY_MESH_SIZE / float(width);
-
-            for (size_t j=0; j<width; ++j)
-            {
-                size_t k        = r*j;
-                b->v[0][j]      = vTimePoints[k];
-            }
 
             cv->set_line_width(2.0f);
             for (size_t i=0; i<nChannels; ++i)
@@ -889,55 +1643,37 @@ namespace lsp
                     continue;
 
                 // Initialize values
-                c->sGraph.read(vIDisplay, meta::trigger_metadata::HISTORY_MESH_SIZE);
+                const float *ys = vIDCoords[i];
                 for (size_t j=0; j<width; ++j)
-                    b->v[1][j]      = vIDisplay[size_t(r*j)];
-
-                // Initialize coords
-                dsp::fill(b->v[2], width, width);
-                dsp::fill(b->v[3], height, width);
-                dsp::fmadd_k3(b->v[2], b->v[0], dx, width);
-                dsp::axis_apply_log1(b->v[3], b->v[1], zy, dy, width);
+                    b->v[1][j]      = ys[size_t(r*j)];
 
                 // Draw channel
                 cv->set_color_rgb((bypass) ? CV_SILVER : c_colors[(nChannels-1)*2 + i]);
-                cv->draw_lines(b->v[2], b->v[3], width);
+                cv->draw_lines(b->v[0], b->v[1], width);
             }
 
             // Draw function (if present)
             if (bFunctionActive)
             {
-                sFunction.read(vIDisplay, meta::trigger_metadata::HISTORY_MESH_SIZE);
+                const float *ys = vIDCoords[nChannels];
                 for (size_t j=0; j<width; ++j)
-                    b->v[1][j]      = vIDisplay[size_t(r*j)];
-
-                // Initialize coords
-                dsp::fill(b->v[2], width, width);
-                dsp::fill(b->v[3], height, width);
-                dsp::fmadd_k3(b->v[2], b->v[0], dx, width);
-                dsp::axis_apply_log1(b->v[3], b->v[1], zy, dy, width);
+                    b->v[1][j]      = ys[size_t(r*j)];
 
                 // Draw channel
                 cv->set_color_rgb((bypass) ? CV_SILVER : CV_GREEN);
-                cv->draw_lines(b->v[2], b->v[3], width);
+                cv->draw_lines(b->v[0], b->v[1], width);
             }
 
             // Draw events (if present)
             if (bVelocityActive)
             {
-                sVelocity.read(vIDisplay, meta::trigger_metadata::HISTORY_MESH_SIZE);
+                const float *ys = vIDCoords[nChannels + 1];
                 for (size_t j=0; j<width; ++j)
-                    b->v[1][j]      = vIDisplay[size_t(r*j)];
-
-                // Initialize coords
-                dsp::fill(b->v[2], width, width);
-                dsp::fill(b->v[3], height, width);
-                dsp::fmadd_k3(b->v[2], b->v[0], dx, width);
-                dsp::axis_apply_log1(b->v[3], b->v[1], zy, dy, width);
+                    b->v[1][j]      = ys[size_t(r*j)];
 
                 // Draw channel
                 cv->set_color_rgb((bypass) ? CV_SILVER : CV_MEDIUM_GREEN);
-                cv->draw_lines(b->v[2], b->v[3], width);
+                cv->draw_lines(b->v[0], b->v[1], width);
             }
 
             // Draw boundaries
@@ -969,6 +1705,9 @@ namespace lsp
             v->write_object("sFunction", &sFunction);
             v->write_object("sVelocity", &sVelocity);
             v->write_object("sActive", &sActive);
+            v->write_object("sEvents", &sEvents);
+            v->write_object("sProfiler", &sProfiler);
+            v->write_object("sCalibrator", &sCalibrator);
 
             v->begin_array("vChannels", &vChannels[0], meta::trigger_metadata::TRACKS_MAX);
             {
@@ -978,6 +1717,8 @@ namespace lsp
                     v->begin_object(c, sizeof(channel_t));
                     {
                         v->write("vCtl", c->vCtl);
+                        v->write("fDotLevel", c->fDotLevel);
+                        v->write("nGraphSync", c->nGraphSync);
                         v->write_object("sBypass", &c->sBypass);
                         v->write_object("sGraph", &c->sGraph);
                         v->write("bVisible", c->bVisible);
@@ -985,6 +1726,7 @@ namespace lsp
                         v->write("pIn", c->pIn);
                         v->write("pOut", c->pOut);
                         v->write("pGraph", c->pGraph);
+                        v->write("pGraphDelta", c->pGraphDelta);
                         v->write("pMeter", c->pMeter);
                         v->write("pVisible", c->pVisible);
                     }
@@ -994,12 +1736,53 @@ namespace lsp
             v->end_array();
             v->write("vTimePoints", vTimePoints);
             v->write("vIDisplay", vIDisplay);
+            v->writev("vIDCoords", vIDCoords, meta::trigger_metadata::TRACKS_MAX + 2);
 
             v->write("nCounter", nCounter);
             v->write("nState", nState);
             v->write("fVelocity", fVelocity);
             v->write("bFunctionActive", bFunctionActive);
             v->write("bVelocityActive", bVelocityActive);
+            v->write("nIdleCounter", nIdleCounter);
+            v->write("nIdleHold", nIdleHold);
+            v->write("fIdleLevel", fIdleLevel);
+            v->write("nDotSamples", nDotSamples);
+            v->write("nDotLeft", nDotLeft);
+            v->write("fFunctionDot", fFunctionDot);
+            v->write("fVelocityDot", fVelocityDot);
+            v->write("bHistory", bHistory);
+            v->write("bUIActive", bUIActive);
+            v->write("bIDisplay", bIDisplay);
+            v->write("bIDisplayDirty", bIDisplayDirty);
+            v->write("bIDisplayQuery", bIDisplayQuery);
+            v->write("fIDisplayRate", fIDisplayRate);
+            v->write("nIDisplayCounter", nIDisplayCounter);
+            v->write("nIDisplayPeriod", nIDisplayPeriod);
+            v->write("nIDisplayWait", nIDisplayWait);
+            v->write("nIDisplayTimeout", nIDisplayTimeout);
+            v->write("nHistoryDots", nHistoryDots);
+            v->write("nIDisplayDots", nIDisplayDots);
+            v->write("nIDisplayHeight", nIDisplayHeight);
+            v->write("nFunctionSync", nFunctionSync);
+            v->write("nVelocitySync", nVelocitySync);
+            v->write("nZoom", nZoom);
+            v->write("nZoomDots", nZoomDots);
+            v->write("nPosition", nPosition);
+            v->write("nChunkOffset", nChunkOffset);
+            v->write("pExecutor", pExecutor);
+            v->write_object("sMidiExporter", &sMidiExporter);
+            v->write_object("sMidiAllocator", &sMidiAllocator);
+            v->write("vMidiRecords", vMidiRecords);
+            v->write("vMidiAlloc", vMidiAlloc);
+            v->write("nMidiRecords", nMidiRecords);
+            v->write("nMidiExport", nMidiExport);
+            v->write("nMidiOrigin", nMidiOrigin);
+            v->write("nMidiStatus", nMidiStatus);
+            v->write("bMidiRecord", bMidiRecord);
+            v->write("bMidiReset", bMidiReset);
+            v->write("bMidiOverflow", bMidiOverflow);
+            v->write("bMidiTruncated", bMidiTruncated);
+            v->write("nEventSync", nEventSync);
 
             v->write("nNote", nNote);
             v->write("nChannel", nChannel);
@@ -1008,6 +1791,10 @@ namespace lsp
             v->write("bPause", bPause);
             v->write("bClear", bClear);
             v->write("bUISync", bUISync);
+            v->write("bMeshSync", bMeshSync);
+            v->write("bCalibrate", bCalibrate);
+            v->write("nCalibrationCounter", nCalibrationCounter);
+            v->write("nCalibrationPeriod", nCalibrationPeriod);
 
             v->write("nDetectCounter", nDetectCounter);
             v->write("nReleaseCounter", nReleaseCounter);
@@ -1021,12 +1808,23 @@ namespace lsp
             v->write_object("pIDisplay", pIDisplay);
 
             v->write("pFunction", pFunction);
+            v->write("pFunctionDelta", pFunctionDelta);
             v->write("pFunctionLevel", pFunctionLevel);
             v->write("pFunctionActive", pFunctionActive);
             v->write("pVelocity", pVelocity);
+            v->write("pVelocityDelta", pVelocityDelta);
             v->write("pVelocityLevel", pVelocityLevel);
             v->write("pVelocityActive", pVelocityActive);
             v->write("pActive", pActive);
+            v->write("pEvents", pEvents);
+            v->write("pProfiling", pProfiling);
+            v->writev("pDspLoad", pDspLoad, TriggerProfiler::ST_TOTAL);
+            v->write("pCalibrate", pCalibrate);
+            v->write("pCalDetectLevel", pCalDetectLevel);
+            v->write("pCalReleaseLevel", pCalReleaseLevel);
+            v->write("pCalDynaRange1", pCalDynaRange1);
+            v->write("pCalDynaRange2", pCalDynaRange2);
+            v->write("pIDisplayRate", pIDisplayRate);
 
             v->write("pMidiIn", pMidiIn);
             v->write("pMidiOut", pMidiOut);
@@ -1034,6 +1832,9 @@ namespace lsp
             v->write("pNote", pNote);
             v->write("pOctave", pOctave);
             v->write("pMidiNote", pMidiNote);
+            v->write("pMidiRecord", pMidiRecord);
+            v->write("pMidiExportFile", pMidiExportFile);
+            v->write("pMidiExportStatus", pMidiExportStatus);
 
             v->write("pBypass", pBypass);
             v->write("pDry", pDry);
@@ -1041,6 +1842,7 @@ namespace lsp
             v->write("pGain", pGain);
             v->write("pPause", pPause);
             v->write("pClear", pClear);
+            v->write("pZoom", pZoom);
             v->write("pPreamp", pPreamp);
             v->write("pScHpfMode", pScHpfMode);
             v->write("pScHpfFreq", pScHpfFreq);
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+
+#include <private/plugins/trigger_calibrator.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        TriggerCalibrator::TriggerCalibrator()
+        {
+            nWindow         = 1;
+            reset();
+        }
+
+        TriggerCalibrator::~TriggerCalibrator()
+        {
+        }
+
+        void TriggerCalibrator::set_sample_rate(size_t sr)
+        {
+            nWindow         = lsp_max(dspu::millis_to_samples(sr, meta::trigger_metadata::CAL_WINDOW), size_t(1));
+            nLeft           = nWindow;
+        }
+
+        void TriggerCalibrator::reset()
+        {
+            for (size_t i=0; i<meta::trigger_metadata::CAL_BINS; ++i)
+            {
+                vWindows[i]     = 0;
+                vPeaks[i]       = 0;
+            }
+
+            nLeft           = nWindow;
+            fLevel          = 0.0f;
+            fPrev           = 0.0f;
+            fPrev2          = 0.0f;
+            nWindows        = 0;
+            nPeaks          = 0;
+        }
+
+        size_t TriggerCalibrator::level_to_bin(float level)
+        {
+            const float db  = dspu::gain_to_db(lsp_max(level, meta::trigger_metadata::CAL_LEVEL_MIN));
+            const ssize_t i = (db - meta::trigger_metadata::CAL_DB_MIN) / meta::trigger_metadata::CAL_DB_STEP;
+            return lsp_limit(i, ssize_t(0), ssize_t(meta::trigger_metadata::CAL_BINS - 1));
+        }
+
+        float TriggerCalibrator::bin_to_db(size_t bin)
+        {
+            return meta::trigger_metadata::CAL_DB_MIN + (bin + 0.5f) * meta::trigger_metadata::CAL_DB_STEP;
+        }
+
+        size_t TriggerCalibrator::percentile(const uint32_t *hist, size_t first, float p)
+        {
+            size_t count    = 0;
+            for (size_t i=first; i<meta::trigger_metadata::CAL_BINS; ++i)
+                count          += hist[i];
+
+            const size_t limit  = p * count;
+            for (size_t i=first, sum=0; i<meta::trigger_metadata::CAL_BINS; ++i)
+            {
+                sum            += hist[i];
+                if (sum > limit)
+                    return i;
+            }
+
+            return meta::trigger_metadata::CAL_BINS - 1;
+        }
+
+        void TriggerCalibrator::process(const float *sc, size_t samples)
+        {
+            for (size_t offset=0; offset < samples; )
+            {
+                const size_t to_do  = lsp_min(samples - offset, nLeft);
+                fLevel              = lsp_max(fLevel, dsp::max(&sc[offset], to_do));
+                offset             += to_do;
+                nLeft              -= to_do;
+                if (nLeft > 0)
+                    break;
+
+                // Account the window maximum and the local peak
+                ++vWindows[level_to_bin(fLevel)];
+                ++nWindows;
+                if ((fPrev > fPrev2) && (fPrev >= fLevel))
+                {
+                    ++vPeaks[level_to_bin(fPrev)];
+                    ++nPeaks;
+                }
+
+                fPrev2              = fPrev;
+                fPrev               = fLevel;
+                fLevel              = 0.0f;
+                nLeft               = nWindow;
+            }
+        }
+
+        bool TriggerCalibrator::analyze(calibration_t *dst, float dynamics) const
+        {
+            if (nWindows <= 0)
+                return false;
+
+            // Estimate the noise floor and consider only peaks that are well above it
+            const size_t noise  = percentile(vWindows, 0, meta::trigger_metadata::CAL_NOISE_PERCENTILE);
+            const size_t first  = lsp_min(noise + size_t(meta::trigger_metadata::CAL_HIT_MARGIN / meta::trigger_metadata::CAL_DB_STEP),
+                                          meta::trigger_metadata::CAL_BINS - 1);
+            size_t hits         = 0;
+            for (size_t i=first; i<meta::trigger_metadata::CAL_BINS; ++i)
+                hits               += vPeaks[i];
+            if (hits < meta::trigger_metadata::CAL_HITS_MIN)
+                return false;
+
+            // Estimate the range of hit levels
+            const float noise_db    = bin_to_db(noise);
+            const float low_db      = bin_to_db(percentile(vPeaks, first, meta::trigger_metadata::CAL_RANGE_PERCENTILE));
+            const float high_db     = bin_to_db(percentile(vPeaks, first, 1.0f - meta::trigger_metadata::CAL_RANGE_PERCENTILE));
+
+            // Detect level lies in the middle between the noise floor and the weakest hits,
+            // release level lies just above the noise floor
+            const float detect_db   = lsp_max((noise_db + low_db) * 0.5f, noise_db + meta::trigger_metadata::CAL_DETECT_MARGIN);
+            const float release_db  = noise_db + meta::trigger_metadata::CAL_RELEASE_MARGIN;
+            const float detect      = dspu::db_to_gain(detect_db);
+
+            dst->fDetectLevel       = detect;
+            dst->fReleaseLevel      = lsp_min(dspu::db_to_gain(release_db - detect_db), 1.0f);
+
+            // Dynamics range is computed for the velocity function of the trigger
+            dst->fDynaTop           = 0.5f * expf(dynamics * logf(dspu::db_to_gain(high_db) / detect));
+            dst->fDynaBottom        = 0.5f * expf(dynamics * logf(dspu::db_to_gain(low_db) / detect));
+
+            return true;
+        }
+
+        void TriggerCalibrator::dump(dspu::IStateDumper *v) const
+        {
+            v->writev("vWindows", vWindows, meta::trigger_metadata::CAL_BINS);
+            v->writev("vPeaks", vPeaks, meta::trigger_metadata::CAL_BINS);
+            v->write("nWindow", nWindow);
+            v->write("nLeft", nLeft);
+            v->write("fLevel", fLevel);
+            v->write("fPrev", fPrev);
+            v->write("fPrev2", fPrev2);
+            v->write("nWindows", nWindows);
+            v->write("nPeaks", nPeaks);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/trigger_events.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        TriggerEventLog::TriggerEventLog()
+        {
+            for (size_t i=0; i<meta::trigger_metadata::EVENT_LOG_SIZE; ++i)
+            {
+                slot_t *s               = &vSlots[i];
+                s->sEvent.nTimestamp    = 0;
+                s->sEvent.fLevel        = 0.0f;
+                s->sEvent.fVelocity     = 0.0f;
+                s->sEvent.nFile         = -1;
+                s->sEvent.nDelay        = 0;
+                atomic_store(&s->nSeq, 0);
+            }
+            atomic_store(&nHead, 0);
+        }
+
+        TriggerEventLog::~TriggerEventLog()
+        {
+        }
+
+        bool TriggerEventLog::get(trigger_event_t *dst, uatomic_t index) const
+        {
+            const slot_t *s         = &vSlots[index & (meta::trigger_metadata::EVENT_LOG_SIZE - 1)];
+
+            // The slot should contain the requested event, it may be being rewritten otherwise
+            const uatomic_t seq     = index + 1;
+            if (atomic_load(&s->nSeq) != seq)
+                return false;
+
+            *dst                    = s->sEvent;
+
+            // Check that the writer has not started to rewrite the slot while reading
+            return atomic_load(&s->nSeq) == seq;
+        }
+
+        void TriggerEventLog::dump(dspu::IStateDumper *v) const
+        {
+            const uatomic_t head    = atomic_load(&nHead);
+            const uatomic_t count   = lsp_min(head, uatomic_t(meta::trigger_metadata::EVENT_LOG_SIZE - 1));
+
+            v->write("nHead", head);
+            v->begin_array("vSlots", vSlots, count);
+            {
+                for (uatomic_t index = head - count; index != head; ++index)
+                {
+                    trigger_event_t ev;
+                    if (!get(&ev, index))
+                        continue;
+
+                    v->begin_object(&vSlots[index & (meta::trigger_metadata::EVENT_LOG_SIZE - 1)], sizeof(slot_t));
+                    {
+                        v->write("nTimestamp", ev.nTimestamp);
+                        v->write("fLevel", ev.fLevel);
+                        v->write("fVelocity", ev.fVelocity);
+                        v->write("nFile", ev.nFile);
+                        v->write("nDelay", ev.nDelay);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
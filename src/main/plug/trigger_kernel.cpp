@@ -26,13 +26,169 @@
 #include <lsp-plug.in/dsp-units/units.h>
 #include <lsp-plug.in/dsp-units/misc/fade.h>
 #include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/mm/InAudioFileStream.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
 
 #include <lsp-plug.in/shared/debug.h>
 
+#include <private/plugins/sample_resampler.h>
+#include <private/plugins/worker_pool.h>
+
 namespace lsp
 {
     namespace plugins
     {
+        /**
+         * Compute positions in the sample for the block of output samples, the positions are computed
+         * once per block and shared by all channels of the sample
+         *
+         * @param idx integer parts of positions
+         * @param t fractional parts of positions
+         * @param offset integer part of the start position
+         * @param frac fractional part of the start position
+         * @param rate position increment per output sample
+         * @param count number of output samples
+         */
+        static void compute_positions(int32_t *idx, float *t, ssize_t offset, double frac, double rate, size_t count)
+        {
+            for (size_t k=0; k<count; ++k)
+            {
+                const double pos    = frac + k * rate;
+                const int32_t ipos  = int32_t(pos);
+                idx[k]              = int32_t(offset) + ipos;
+                t[k]                = float(pos - ipos);
+            }
+        }
+
+        static inline float sample_at(const float *src, ssize_t length, ssize_t i)
+        {
+            return ((i >= 0) && (i < length)) ? src[i] : 0.0f;
+        }
+
+        /**
+         * Gather the samples at the integer positions shifted by the tap offset into the contiguous buffer,
+         * samples outside of the sample bounds are considered to be zero
+         *
+         * @param dst destination buffer
+         * @param src sample data
+         * @param length length of the sample
+         * @param idx integer parts of positions
+         * @param shift offset of the tap relative to the position
+         * @param first first output sample for which all taps are within the sample bounds
+         * @param last output sample after the last one for which all taps are within the sample bounds
+         * @param count number of output samples
+         */
+        static void gather(float *dst, const float *src, ssize_t length, const int32_t *idx, ssize_t shift,
+            size_t first, size_t last, size_t count)
+        {
+            for (size_t k=0; k<first; ++k)
+                dst[k]          = sample_at(src, length, idx[k] + shift);
+            for (size_t k=first; k<last; ++k)
+                dst[k]          = src[idx[k] + shift];
+            for (size_t k=last; k<count; ++k)
+                dst[k]          = sample_at(src, length, idx[k] + shift);
+        }
+
+        /**
+         * Read the sample at fractional positions using 4-point cubic Hermite interpolation,
+         * samples outside of the sample bounds are considered to be zero. The taps are gathered
+         * into contiguous buffers first, so the interpolation itself is computed on vectors
+         *
+         * @param dst destination buffer
+         * @param src sample data
+         * @param length length of the sample
+         * @param idx integer parts of positions
+         * @param t fractional parts of positions
+         * @param taps buffer to store taps, should be at least of 4*count size
+         * @param count number of output samples
+         */
+        static void interpolate(float *dst, const float *src, ssize_t length, const int32_t *idx, const float *t,
+            float *taps, size_t count)
+        {
+            float *xm1      = taps;
+            float *x0       = &xm1[count];
+            float *x1       = &x0[count];
+            float *x2       = &x1[count];
+
+            // Positions do not decrease, so bound checks are required only at the head and the tail of the block
+            size_t first = 0, last = count;
+            while ((first < last) && (idx[first] < 1))
+                ++first;
+            while ((last > first) && (idx[last - 1] + 2 >= length))
+                --last;
+
+            gather(xm1, src, length, idx, -1, first, last, count);
+            gather(x0, src, length, idx, 0, first, last, count);
+            gather(x1, src, length, idx, 1, first, last, count);
+            gather(x2, src, length, idx, 2, first, last, count);
+
+            for (size_t k=0; k<count; ++k)
+            {
+                const float c1  = 0.5f * (x1[k] - xm1[k]);
+                const float c2  = xm1[k] - 2.5f * x0[k] + 2.0f * x1[k] - 0.5f * x2[k];
+                const float c3  = 0.5f * (x2[k] - xm1[k]) + 1.5f * (x0[k] - x1[k]);
+                dst[k]          = ((c3 * t[k] + c2) * t[k] + c1) * t[k] + x0[k];
+            }
+        }
+
+        /**
+         * Read channels of the sample at fractional positions with the playback rate above 1 using the
+         * windowed sinc kernel stretched by the playback rate, so the signal is band-limited
+         * to the output sample rate. Samples outside of the sample bounds are considered to be zero.
+         * The block is processed tap by tap: the kernel weights of the tap are computed once for
+         * all channels and applied to the gathered samples of each channel as vectors
+         *
+         * @param dst list of destination buffers
+         * @param src list of sample channels
+         * @param channels number of channels
+         * @param length length of the sample
+         * @param idx integer parts of positions
+         * @param t fractional parts of positions
+         * @param taps buffer to store kernel weights and gathered samples, should be at least of 2*count size
+         * @param rate position increment per output sample, should be greater than 1
+         * @param count number of output samples
+         * @param kernel tabulated half of the Lanczos kernel
+         */
+        static void interpolate_aa(float * const *dst, const float * const *src, size_t channels, ssize_t length,
+            const int32_t *idx, const float *t, float *taps, double rate, size_t count, const float *kernel)
+        {
+            const float scale       = 1.0f / rate;
+            const float kscale      = scale * meta::trigger_metadata::AA_RESOLUTION;
+            const float umax        = meta::trigger_metadata::AA_LOBES * meta::trigger_metadata::AA_RESOLUTION;
+            const ssize_t radius    = ssize_t(meta::trigger_metadata::AA_LOBES * rate);
+            float *w                = taps;
+            float *x                = &taps[count];
+
+            // Fractional part of position is in [0, 1), so the taps within the kernel radius
+            // lie in the range [idx - radius, idx + radius + 1]
+            size_t first = 0, last = count;
+            while ((first < last) && (idx[first] < radius))
+                ++first;
+            while ((last > first) && (idx[last - 1] + radius + 1 >= length))
+                --last;
+
+            for (size_t i=0; i<channels; ++i)
+                dsp::fill_zero(dst[i], count);
+
+            for (ssize_t m=-radius; m<=radius + 1; ++m)
+            {
+                // The kernel table ends with zeros, so taps outside of the radius get zero weight
+                for (size_t k=0; k<count; ++k)
+                {
+                    const float u           = lsp_min(fabsf(float(m) - t[k]) * kscale, umax);
+                    const int32_t ui        = int32_t(u);
+                    w[k]                    = (kernel[ui] + (kernel[ui + 1] - kernel[ui]) * (u - ui)) * scale;
+                }
+
+                for (size_t i=0; i<channels; ++i)
+                {
+                    gather(x, src[i], length, idx, m, first, last, count);
+                    dsp::fmadd3(dst[i], x, w, count);
+                }
+            }
+        }
+
         //-------------------------------------------------------------------------
         trigger_kernel::AFLoader::AFLoader(trigger_kernel *base, afile_t *descr)
         {
@@ -89,6 +245,31 @@ namespace lsp
             v->write("pFile", pFile);
         }
 
+        //-------------------------------------------------------------------------
+        trigger_kernel::KitLoader::KitLoader(trigger_kernel *base)
+        {
+            pCore       = base;
+        }
+
+        trigger_kernel::KitLoader::~KitLoader()
+        {
+            pCore       = NULL;
+        }
+
+        status_t trigger_kernel::KitLoader::run()
+        {
+            dsp::context_t ctx;
+            dsp::start(&ctx);
+            lsp_finally { dsp::finish(&ctx); };
+
+            return pCore->load_kit();
+        }
+
+        void trigger_kernel::KitLoader::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pCore", pCore);
+        }
+
         //-------------------------------------------------------------------------
         trigger_kernel::GCTask::GCTask(trigger_kernel *base)
         {
@@ -113,25 +294,52 @@ namespace lsp
 
         //-------------------------------------------------------------------------
         trigger_kernel::trigger_kernel():
-            sGCTask(this)
+            sGCTask(this),
+            sKitLoader(this)
         {
             pExecutor       = NULL;
+            pProfiler       = NULL;
             vFiles          = NULL;
             vActive         = NULL;
+            vVoices         = NULL;
+            pFreeVoices     = NULL;
             pGCList         = NULL;
+            pGCPending      = NULL;
+            nGCCount        = 0;
+            nGCBytes        = 0;
+            nGCTimer        = 0;
+            vKitFiles       = NULL;
+            nKitFiles       = 0;
+            nKitNext        = 0;
+            nKitDone        = 0;
+            nLoadDefer      = 0;
+            nCacheState     = CACHE_NONE;
             nFiles          = 0;
             nActive         = 0;
             nChannels       = 0;
+            nVoices         = 0;
             vBuffer         = NULL;
+            vIndex          = NULL;
+            vFrac           = NULL;
+            vTaps           = NULL;
+            vAAKernel       = NULL;
             bBypass         = false;
             bReorder        = false;
+            bAtomicKit      = false;
             fFadeout        = 10.0f;
             fDynamics       = meta::trigger_metadata::DYNA_DFL;
             fDrift          = meta::trigger_metadata::DRIFT_DFL;
+            fPitchVar       = meta::trigger_metadata::PITCH_VAR_DFL;
+            fGain           = 1.0f;
             nSampleRate     = 0;
 
             pDynamics       = NULL;
             pDrift          = NULL;
+            pKitSwitch      = NULL;
+            pKitPending     = NULL;
+            pPitchVar       = NULL;
+            pQueueDepth     = NULL;
+            pKitProgress    = NULL;
             pActivity       = NULL;
             pData           = NULL;
         }
@@ -147,6 +355,16 @@ namespace lsp
             fFadeout        = length;
         }
 
+        void trigger_kernel::set_gain(float gain)
+        {
+            fGain           = gain;
+        }
+
+        void trigger_kernel::set_profiler(TriggerProfiler *profiler)
+        {
+            pProfiler       = profiler;
+        }
+
         bool trigger_kernel::init(ipc::IExecutor *executor, size_t files, size_t channels)
         {
             // Validate parameters
@@ -162,10 +380,18 @@ namespace lsp
             // Now determine object sizes
             size_t afile_szof           = align_size(sizeof(afile_t) * files, DEFAULT_ALIGN);
             size_t vactive_szof         = align_size(sizeof(afile_t *) * files, DEFAULT_ALIGN);
-            size_t vbuffer_szof         = align_size(sizeof(float) * meta::trigger_metadata::BUFFER_SIZE, DEFAULT_ALIGN);
+            size_t vvoices_szof         = align_size(sizeof(voice_t) * meta::trigger_metadata::PLAYBACKS_MAX, DEFAULT_ALIGN);
+            size_t vbuffer_szof         = align_size(sizeof(float) * meta::trigger_metadata::BUFFER_SIZE * meta::trigger_metadata::TRACKS_MAX, DEFAULT_ALIGN);
+            size_t vindex_szof          = align_size(sizeof(int32_t) * meta::trigger_metadata::BUFFER_SIZE, DEFAULT_ALIGN);
+            size_t vfrac_szof           = align_size(sizeof(float) * meta::trigger_metadata::BUFFER_SIZE, DEFAULT_ALIGN);
+            size_t vtaps_szof           = align_size(sizeof(float) * meta::trigger_metadata::BUFFER_SIZE * 4, DEFAULT_ALIGN);
+            size_t vthumbs_szof         = align_size(sizeof(float) * meta::trigger_metadata::MESH_SIZE * meta::trigger_metadata::TRACKS_MAX, DEFAULT_ALIGN);
+            size_t aa_points            = meta::trigger_metadata::AA_LOBES * meta::trigger_metadata::AA_RESOLUTION;
+            size_t vaakernel_szof       = align_size(sizeof(float) * (aa_points + 2), DEFAULT_ALIGN);
 
             // Allocate raw chunk and link data
-            size_t allocate             = afile_szof + vactive_szof + vbuffer_szof;
+            size_t allocate             = afile_szof + vactive_szof * 2 + vvoices_szof + vbuffer_szof + vindex_szof + vfrac_szof + vtaps_szof +
+                                          vaakernel_szof + vthumbs_szof * files;
             uint8_t *ptr                = alloc_aligned<uint8_t>(pData, allocate);
             if (ptr == NULL)
                 return false;
@@ -176,7 +402,36 @@ namespace lsp
             // Allocate files
             vFiles                      = advance_ptr_bytes<afile_t>(ptr, afile_szof);
             vActive                     = advance_ptr_bytes<afile_t *>(ptr, vactive_szof);
+            vKitFiles                   = advance_ptr_bytes<afile_t *>(ptr, vactive_szof);
+            nKitFiles                   = 0;
+            vVoices                     = advance_ptr_bytes<voice_t>(ptr, vvoices_szof);
             vBuffer                     = advance_ptr_bytes<float>(ptr, vbuffer_szof);
+            vIndex                      = advance_ptr_bytes<int32_t>(ptr, vindex_szof);
+            vFrac                       = advance_ptr_bytes<float>(ptr, vfrac_szof);
+            vTaps                       = advance_ptr_bytes<float>(ptr, vtaps_szof);
+            vAAKernel                   = advance_ptr_bytes<float>(ptr, vaakernel_szof);
+
+            // Tabulate the half of the Lanczos kernel, the extra point is used for the interpolation
+            vAAKernel[0]                = 1.0f;
+            for (size_t i=1; i<aa_points; ++i)
+            {
+                const float x               = (M_PI * i) / meta::trigger_metadata::AA_RESOLUTION;
+                const float xa              = x / meta::trigger_metadata::AA_LOBES;
+                vAAKernel[i]                = (sinf(x) / x) * (sinf(xa) / xa);
+            }
+            vAAKernel[aa_points]        = 0.0f;
+            vAAKernel[aa_points + 1]    = 0.0f;
+
+            // Initialize the pool of voices
+            pFreeVoices                 = NULL;
+            nVoices                     = 0;
+            for (size_t i=meta::trigger_metadata::PLAYBACKS_MAX; i > 0; )
+            {
+                voice_t *v                  = &vVoices[--i];
+                v->pNext                    = pFreeVoices;
+                v->pSample                  = NULL;
+                pFreeVoices                 = v;
+            }
 
             for (size_t i=0; i<files; ++i)
             {
@@ -190,16 +445,31 @@ namespace lsp
                 af->sStop.construct();
                 af->sNoteOn.construct();
                 af->pOriginal               = NULL;
+                af->pResampled              = NULL;
                 af->pProcessed              = NULL;
+                af->nSource                 = 0;
+                // Thumbnails are allocated once and reused by all loaded files
+                float *thumbs               = advance_ptr_bytes<float>(ptr, vthumbs_szof);
                 for (size_t j=0; j<meta::trigger_metadata::TRACKS_MAX; ++j)
-                    af->vThumbs[j]              = NULL;
+                {
+                    af->vThumbs[j]              = thumbs;
+                    thumbs                     += meta::trigger_metadata::MESH_SIZE;
+                }
 
-                for (size_t i=0; i<4; ++i)
-                    af->vPlaybacks[i].construct();
+                af->pVoices                 = NULL;
 
                 af->nUpdateReq              = 0;
                 af->nUpdateResp             = 0;
                 af->bSync                   = false;
+                af->bStaged                 = false;
+                af->bDraft                  = false;
+                af->bDraftReq               = false;
+                af->nSettle                 = 0;
+                af->bCache                  = false;
+                af->bCacheReq               = false;
+                af->bBulk                   = false;
+                af->nBulkStatus             = STATUS_OK;
+                af->nBulkDone               = 0;
                 af->fVelocity               = 1.0f;
                 af->fPitch                  = 0.0f;
                 af->fHeadCut                = 0.0f;
@@ -269,11 +539,11 @@ namespace lsp
             // Assert
             lsp_assert(ptr <= tail);
 
-            // Initialize channels
+            // Initialize channels, sample players only keep bound samples, all playbacks are performed by voices
             lsp_trace("Initialize channels");
             for (size_t i=0; i<nChannels; ++i)
             {
-                if (!vChannels[i].init(nFiles, meta::trigger_metadata::PLAYBACKS_MAX))
+                if (!vChannels[i].init(nFiles, 1))
                 {
                     destroy_state();
                     return false;
@@ -292,6 +562,13 @@ namespace lsp
                 BIND_PORT(pDrift);
             }
 
+            lsp_trace("Binding kit switching...");
+            BIND_PORT(pKitSwitch);
+            BIND_PORT(pKitPending);
+            BIND_PORT(pPitchVar);
+            BIND_PORT(pQueueDepth);
+            BIND_PORT(pKitProgress);
+
             SKIP_PORT("Sample selector");
 
             // Iterate each file
@@ -354,15 +631,8 @@ namespace lsp
         {
             // Destroy original sample if present
             destroy_sample(af->pOriginal);
+            destroy_sample(af->pResampled);
             destroy_sample(af->pProcessed);
-
-            // Destroy pointer to thumbnails
-            if (af->vThumbs[0])
-            {
-                free(af->vThumbs[0]);
-                for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX; ++i)
-                    af->vThumbs[i]              = NULL;
-            }
         }
 
         void trigger_kernel::destroy_afile(afile_t *af)
@@ -371,9 +641,6 @@ namespace lsp
             af->sStop.destroy();
             af->sNoteOn.destroy();
 
-            for (size_t i=0; i<4; ++i)
-                af->vPlaybacks[i].destroy();
-
             // Delete audio file loader
             if (af->pLoader != NULL)
             {
@@ -415,6 +682,13 @@ namespace lsp
 
         void trigger_kernel::destroy_state()
         {
+            // Release samples held by voices
+            if (vFiles != NULL)
+            {
+                for (size_t i=0; i<nFiles; ++i)
+                    drop_voices(&vFiles[i]);
+            }
+
             // Perform garbage collection for each channel
             for (size_t i=0; i<nChannels; ++i)
             {
@@ -432,6 +706,11 @@ namespace lsp
 
             // Perform pending gabrage collection
             perform_gc();
+            destroy_samples(pGCPending);
+            pGCPending      = NULL;
+            nGCCount        = 0;
+            nGCBytes        = 0;
+            nGCTimer        = 0;
 
             // Drop all preallocated data
             free_aligned(pData);
@@ -439,15 +718,30 @@ namespace lsp
             // Foget variables
             vFiles          = NULL;
             vActive         = NULL;
+            vKitFiles       = NULL;
+            nKitFiles       = 0;
+            vVoices         = NULL;
+            pFreeVoices     = NULL;
             vBuffer         = NULL;
+            vIndex          = NULL;
+            vFrac           = NULL;
+            vTaps           = NULL;
+            vAAKernel       = NULL;
             pExecutor       = NULL;
             nFiles          = 0;
             nChannels       = 0;
+            nVoices         = 0;
             bReorder        = false;
             bBypass         = false;
+            bAtomicKit      = false;
 
             pDynamics       = NULL;
             pDrift          = NULL;
+            pKitSwitch      = NULL;
+            pKitPending     = NULL;
+            pPitchVar       = NULL;
+            pQueueDepth     = NULL;
+            pKitProgress    = NULL;
         }
 
         void trigger_kernel::destroy()
@@ -463,6 +757,8 @@ namespace lsp
             {
                 field       = temp;
                 ++af->nUpdateReq;
+                af->bDraftReq   = true;
+                af->nSettle     = 0;
             }
         }
 
@@ -473,36 +769,15 @@ namespace lsp
             {
                 field       = temp;
                 ++af->nUpdateReq;
+                af->bDraftReq   = true;
+                af->nSettle     = 0;
             }
         }
 
         void trigger_kernel::update_settings()
         {
-            // Process file load requests
-            for (size_t i=0; i<nFiles; ++i)
-            {
-                // Get descriptor
-                afile_t *af             = &vFiles[i];
-                if (af->pFile == NULL)
-                    continue;
-
-                // Get path
-                plug::path_t *path = af->pFile->buffer<plug::path_t>();
-                if ((path == NULL) || (!path->pending()))
-                    continue;
-
-                // Check task state
-                if (af->pLoader->idle())
-                {
-                    // Try to submit task
-                    if (pExecutor->submit(af->pLoader))
-                    {
-                        af->nStatus     = STATUS_LOADING;
-                        lsp_trace("successfully submitted task");
-                        path->accept();
-                    }
-                }
-            }
+            // File load requests are processed by process_file_load_requests() which
+            // loads all files requested at the same time as a kit
 
             // Update note and octave
             lsp_trace("Initializing samples...");
@@ -558,7 +833,7 @@ namespace lsp
 
                 // Update sample parameters
                 commit_afile_value(af, af->fVelocity, af->pVelocity);
-                commit_afile_value(af, af->fPitch, af->pPitch);
+                af->fPitch      = af->pPitch->value();  // Pitch is applied by voices and does not require re-rendering
                 commit_afile_value(af, af->fHeadCut, af->pHeadCut);
                 commit_afile_value(af, af->fTailCut, af->pTailCut);
                 commit_afile_value(af, af->fFadeIn, af->pFadeIn);
@@ -569,6 +844,8 @@ namespace lsp
             // Get humanisation parameters
             fDynamics       = (pDynamics != NULL) ? pDynamics->value() * 0.01f : 0.0f; // fDynamics = 0..1.0
             fDrift          = (pDrift != NULL)    ? pDrift->value() : 0.0f;
+            bAtomicKit      = (pKitSwitch != NULL) ? pKitSwitch->value() >= 0.5f : false;
+            fPitchVar       = (pPitchVar != NULL) ? pPitchVar->value() : 0.0f;
         }
 
         void trigger_kernel::sync_samples_with_ui()
@@ -590,7 +867,79 @@ namespace lsp
             sActivity.init(sr);
 
             for (size_t i=0; i<nFiles; ++i)
-                vFiles[i].sNoteOn.init(sr);
+            {
+                afile_t *af         = &vFiles[i];
+                af->sNoteOn.init(sr);
+
+                // Rendered samples depend on the sample rate: schedule the re-render,
+                // the previous render remains bound until the new one is ready
+                if (af->pOriginal == NULL)
+                    continue;
+                ++af->nUpdateReq;
+                af->bCacheReq       = true;
+                if (af->nStatus == STATUS_OK)
+                    af->nStatus         = STATUS_LOADING;
+            }
+        }
+
+        status_t trigger_kernel::decode_file(dspu::Sample *dst, const char *fname)
+        {
+            mm::InAudioFileStream is;
+            status_t res            = is.open(fname);
+            if (res != STATUS_OK)
+                return res;
+            lsp_finally { is.close(); };
+
+            mm::audio_stream_t info;
+            if ((res = is.info(&info)) != STATUS_OK)
+                return res;
+            if ((info.channels <= 0) || (info.frames < 0))
+                return STATUS_UNSUPPORTED_FORMAT;
+
+            // Decode only the frames and the channels that will be used
+            const size_t src_channels   = info.channels;
+            const size_t channels       = lsp_min(nChannels, src_channels);
+            const size_t frames         = lsp_min(wsize_t(info.frames),
+                wsize_t(dspu::millis_to_samples(info.srate, meta::trigger_metadata::SAMPLE_LENGTH_MAX)));
+            if (!dst->init(channels, frames, frames))
+                return STATUS_NO_MEM;
+            dst->set_sample_rate(info.srate);
+
+            // Decode the file by chunks and take only needed channels from the interleaved data
+            const size_t chunk          = meta::trigger_metadata::BUFFER_SIZE;
+            float *buf                  = static_cast<float *>(malloc(sizeof(float) * chunk * src_channels));
+            if (buf == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { free(buf); };
+
+            size_t offset               = 0;
+            while (offset < frames)
+            {
+                const ssize_t read          = is.read(buf, lsp_min(frames - offset, chunk));
+                if (read < 0)
+                {
+                    if (read == -STATUS_EOF)
+                        break;
+                    return status_t(-read);
+                }
+                else if (read == 0)
+                    break;
+
+                for (size_t i=0; i<channels; ++i)
+                {
+                    float *dptr                 = &dst->channel(i)[offset];
+                    const float *sptr           = &buf[i];
+                    for (ssize_t j=0; j<read; ++j, sptr += src_channels)
+                        dptr[j]                     = *sptr;
+                }
+
+                offset                     += read;
+            }
+
+            if (!dst->set_length(offset))
+                return STATUS_NO_MEM;
+
+            return STATUS_OK;
         }
 
         status_t trigger_kernel::load_file(afile_t *file)
@@ -617,37 +966,50 @@ namespace lsp
                 return STATUS_NO_MEM;
             lsp_finally { destroy_sample(source); };
 
-            status_t status = source->load(fname, meta::trigger_metadata::SAMPLE_LENGTH_MAX * 0.001f);
+            status_t status = decode_file(source, fname);
             if (status != STATUS_OK)
             {
-                lsp_trace("load failed: status=%d (%s)", status, get_status(status));
-                return status;
+                // Fall back to the generic loader
+                lsp_trace("stream decoding failed: status=%d (%s)", status, get_status(status));
+                status = source->load(fname, meta::trigger_metadata::SAMPLE_LENGTH_MAX * 0.001f);
+                if (status != STATUS_OK)
+                {
+                    lsp_trace("load failed: status=%d (%s)", status, get_status(status));
+                    return status;
+                }
             }
             const size_t channels   = lsp_min(nChannels, source->channels());
             if (!source->set_channels(channels))
             {
                 lsp_trace("failed to resize source sample to %d channels", int(channels));
-                return status;
-            }
-
-            // Initialize thumbnails
-            float *thumbs           = static_cast<float *>(malloc(sizeof(float) * channels * meta::trigger_metadata::MESH_SIZE));
-            if (thumbs == NULL)
                 return STATUS_NO_MEM;
-
-            for (size_t i=0; i<channels; ++i)
-            {
-                file->vThumbs[i]        = thumbs;
-                thumbs                 += meta::trigger_metadata::MESH_SIZE;
             }
 
             // Commit result
             lsp_trace("file successful loaded: %s", fname);
+            file->nSource           = SampleCache::source_hash(fname);
             lsp::swap(file->pOriginal, source);
 
             return STATUS_OK;
         }
 
+        bool trigger_kernel::enable_cache()
+        {
+            // The cache touches the file system, so it is initialized by the first render in the
+            // background task rather than for each instance of the plugin. Renders which run
+            // concurrently with the initialization do not wait for it and just skip the cache.
+            if (atomic_cas(&nCacheState, CACHE_NONE, CACHE_INIT))
+            {
+                // The cache is optional, samples are rendered each time if it is not available
+                status_t res    = sCache.init("lsp-plugins-trigger-cache", meta::trigger_metadata::SAMPLE_CACHE_SIZE);
+                if (res != STATUS_OK)
+                    lsp_trace("sample cache is not available: status=%d (%s)", int(res), get_status(res));
+                atomic_store(&nCacheState, CACHE_READY);
+            }
+
+            return atomic_load(&nCacheState) == CACHE_READY;
+        }
+
         status_t trigger_kernel::render_sample(afile_t *af)
         {
             // Validate arguments
@@ -659,19 +1021,76 @@ namespace lsp
             if (src == NULL)
                 return STATUS_UNSPECIFIED;
 
-            // Copy data of original sample to temporary sample and perform resampling
-            dspu::Sample temp;
             size_t channels         = lsp_min(nChannels, src->channels());
-            size_t sample_rate_dst  = nSampleRate * dspu::semitones_to_frequency_shift(-af->fPitch);
-            if (temp.copy(src) != STATUS_OK)
+            size_t sample_rate_dst  = nSampleRate;
+
+            // Render draft only for long samples, short ones are rendered fast enough
+            af->bDraft              = (af->bDraft) && (src->duration() * 1000.0f >= meta::trigger_metadata::SAMPLE_DRAFT_LENGTH_MIN);
+
+            // Try to obtain the rendered sample from the cache first
+            const bool cache        = enable_cache();
+            SampleCache::key_t key;
+            bzero(&key, sizeof(key));
+            key.nSource             = af->nSource;
+            key.nChannels           = channels;
+            key.nSampleRate         = sample_rate_dst;
+            key.nThumbs             = meta::trigger_metadata::MESH_SIZE;
+            key.fHeadCut            = af->fHeadCut;
+            key.fTailCut            = af->fTailCut;
+            key.fFadeIn             = af->fFadeIn;
+            key.fFadeOut            = af->fFadeOut;
+            key.nReverse            = (af->bReverse) ? 1 : 0;
+
             {
-                lsp_warn("Error copying source sample");
-                return STATUS_NO_MEM;
+                dspu::Sample *cached    = new dspu::Sample();
+                if (cached == NULL)
+                    return STATUS_NO_MEM;
+                lsp_finally { destroy_sample(cached); };
+
+                if ((cache) && (sCache.load(&key, cached, af->vThumbs) == STATUS_OK))
+                {
+                    af->bDraft              = false;
+                    lsp::swap(cached, af->pProcessed);
+                    return STATUS_OK;
+                }
+            }
+
+            // Resample the original sample, long samples are processed in parallel. The high-quality result
+            // is kept for the next renders of the file, so edits of cuts, fades and reverse only re-apply them.
+            // The draft quality is used only until the high-quality result is available.
+            // The original sample is used directly if it does not need resampling
+            dspu::Sample temp;
+            const dspu::Sample *data    = src;
+            if (src->sample_rate() == sample_rate_dst)
+                af->bDraft                  = false;
+            else if ((af->pResampled != NULL) && (af->pResampled->sample_rate() == sample_rate_dst))
+            {
+                data                        = af->pResampled;
+                af->bDraft                  = false;
             }
-            if (temp.resample(sample_rate_dst) != STATUS_OK)
+            else if (af->bDraft)
             {
-                lsp_warn("Error resampling source sample");
-                return STATUS_NO_MEM;
+                if (SampleResampler::resample(&temp, src, sample_rate_dst, SampleResampler::Q_DRAFT) != STATUS_OK)
+                {
+                    lsp_warn("Error resampling source sample");
+                    return STATUS_NO_MEM;
+                }
+                data                        = &temp;
+            }
+            else
+            {
+                dspu::Sample *resampled     = new dspu::Sample();
+                if (resampled == NULL)
+                    return STATUS_NO_MEM;
+                lsp_finally { destroy_sample(resampled); };
+
+                if (SampleResampler::resample(resampled, src, sample_rate_dst, SampleResampler::Q_HIGH) != STATUS_OK)
+                {
+                    lsp_warn("Error resampling source sample");
+                    return STATUS_NO_MEM;
+                }
+                lsp::swap(resampled, af->pResampled);
+                data                        = af->pResampled;
             }
 
             // Determine the normalizing factor
@@ -679,7 +1098,7 @@ namespace lsp
             for (size_t i=0; i<channels; ++i)
             {
                 // Determine the maximum amplitude
-                float a_max             = dsp::abs_max(temp.channel(i), temp.length());
+                float a_max             = dsp::abs_max(data->channel(i), data->length());
                 abs_max                 = lsp_max(abs_max, a_max);
             }
             float norming       = (abs_max != 0.0f) ? 1.0f / abs_max : 1.0f;
@@ -687,7 +1106,7 @@ namespace lsp
             // Compute the overall sample length
             ssize_t head        = dspu::millis_to_samples(sample_rate_dst, af->fHeadCut);
             ssize_t tail        = dspu::millis_to_samples(sample_rate_dst, af->fTailCut);
-            ssize_t max_samples = lsp_max(0, ssize_t(temp.length() - head - tail));
+            ssize_t max_samples = lsp_max(0, ssize_t(data->length() - head - tail));
             ssize_t fade_in     = dspu::millis_to_samples(nSampleRate, af->fFadeIn);
             ssize_t fade_out    = dspu::millis_to_samples(nSampleRate, af->fFadeOut);
 
@@ -702,11 +1121,11 @@ namespace lsp
                 return STATUS_NO_MEM;
             }
 
-            // Re-render playback sample from temporary sample
+            // Re-render playback sample from the resampled data
             for (size_t j=0; j<channels; ++j)
             {
                 float *dst          = out->channel(j);
-                const float *src    = temp.channel(j);
+                const float *src    = data->channel(j);
 
                 if (af->bReverse)
                 {
@@ -737,67 +1156,178 @@ namespace lsp
                     dsp::mul_k2(dst, norming, meta::trigger_metadata::MESH_SIZE);
             }
 
+            // Store the rendered sample to the cache, the failure does not affect the result.
+            // Only samples bound after loading and settled high-quality renders are stored,
+            // intermediate values of edited parameters are not
+            if ((cache) && (af->bCache) && (!af->bDraft))
+            {
+                status_t res        = sCache.store(&key, out, af->vThumbs);
+                if (res != STATUS_OK)
+                    lsp_trace("could not store sample to cache: status=%d (%s)", int(res), get_status(res));
+            }
+
             // Commit the new sample to the processed
             lsp::swap(out, af->pProcessed);
 
             return STATUS_OK;
         }
 
-        void trigger_kernel::play_sample(const afile_t *af, float gain, size_t delay)
+        void trigger_kernel::kit_worker(void *arg)
+        {
+            trigger_kernel *self = static_cast<trigger_kernel *>(arg);
+            self->run_kit_worker();
+        }
+
+        void trigger_kernel::run_kit_worker()
+        {
+            while (true)
+            {
+                const size_t idx    = atomic_add(&nKitNext, 1);
+                if (idx >= nKitFiles)
+                    break;
+
+                // Render the file immediately after it has been decoded
+                afile_t *af         = vKitFiles[idx];
+                status_t res        = load_file(af);
+                af->nBulkStatus     = res;
+                if (res == STATUS_OK)
+                {
+                    res                 = render_sample(af);
+                    if (res != STATUS_OK)
+                        lsp_trace("could not render file id=%d: status=%d (%s)", int(af->nID), int(res), get_status(res));
+                }
+
+                // Publish the result of the file to the audio thread
+                atomic_store(&af->nBulkDone, 1);
+                atomic_add(&nKitDone, 1);
+            }
+        }
+
+        status_t trigger_kernel::load_kit()
+        {
+            // Files are loaded by the current thread and the helper threads available in the process.
+            // The resamplers of the files take helpers from the same global budget, so nested work
+            // does not start more threads than there are cores
+            const size_t workers    = lsp_min(nKitFiles, size_t(meta::trigger_metadata::KIT_THREADS_MAX));
+            WorkerPool::run(kit_worker, this, workers);
+
+            return STATUS_OK;
+        }
+
+        void trigger_kernel::play_sample(afile_t *af, float gain, size_t delay, float pitch, bool listen)
         {
-            lsp_trace("id=%d, gain=%f, delay=%d", int(af->nID), gain, int(delay));
+            lsp_trace("id=%d, gain=%f, delay=%d, pitch=%f, listen=%d", int(af->nID), gain, int(delay), pitch, int(listen));
 
             // Obtain the sample that will be used for playback
             dspu::Sample *s = vChannels[0].get(af->nID);
             if (s == NULL)
                 return;
 
+            // Allocate the voice
+            voice_t *v      = pFreeVoices;
+            if (v == NULL)
+            {
+                lsp_trace("no free voices for sample id=%d", int(af->nID));
+                return;
+            }
+
             // Scale the final output gain
             gain    *= af->fMakeup;
 
+            // Compute the gain matrix: each sample channel is read only once and mixed to all outputs
+            const size_t s_channels = s->channels();
+            for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX; ++i)
+                for (size_t j=0; j<meta::trigger_metadata::TRACKS_MAX; ++j)
+                    v->vGains[i][j]     = 0.0f;
+
             if (nChannels == 1)
-            {
-                lsp_trace("channels[%d].play(%d, %d, %f, %d)", int(0), int(af->nID), int(0), gain * af->fGains[0], int(delay));
-                vChannels[0].play(af->nID, 0, gain * af->fGains[0], delay);
-            }
+                v->vGains[0][0]     = gain * af->fGains[0];
             else if (nChannels == 2)
             {
                 for (size_t i=0; i<nChannels; ++i)
                 {
                     size_t j=i^1; // j = (i + 1) % 2
-                    const size_t channel = i % s->channels();
+                    const size_t channel = i % s_channels;
 
-                    lsp_trace("channels[%d].play(%d, %d, %f, %d)", int(i), int(af->nID), int(i), gain * af->fGains[i], int(delay));
-                    vChannels[i].play(af->nID, channel, gain * af->fGains[i], delay);
-                    lsp_trace("channels[%d].play(%d, %d, %f, %d)", int(j), int(af->nID), int(i), gain * (1.0f - af->fGains[i]), int(delay));
-                    vChannels[j].play(af->nID, channel, gain * (1.0f - af->fGains[i]), delay);
+                    v->vGains[channel][i]  += gain * af->fGains[i];
+                    v->vGains[channel][j]  += gain * (1.0f - af->fGains[i]);
                 }
             }
             else
             {
                 for (size_t i=0; i<nChannels; ++i)
-                {
-                    const size_t channel = i % s->channels();
+                    v->vGains[i % s_channels][i]   += gain * af->fGains[i];
+            }
 
-                    lsp_trace("channels[%d].play(%d, %d, %f, %d)", int(i), int(af->nID), int(i), gain * af->fGains[i], int(delay));
-                    vChannels[i].play(af->nID, channel, gain * af->fGains[i], delay);
-                }
+            // Initialize the voice and link it to the list of voices of the file
+            pFreeVoices     = v->pNext;
+            v->pSample      = s;
+            s->gc_acquire();        // The sample is kept alive until the voice ends
+            v->nOffset      = 0;
+            v->fFrac        = 0.0f;
+            v->fRate        = (pitch != 0.0f) ? dspu::semitones_to_frequency_shift(pitch) : 1.0f;
+            v->bListen      = listen;
+            v->nTime        = -ssize_t(delay);
+            v->nEnd         = (v->fRate != 1.0f) ? ssize_t(ceil(double(s->length()) / v->fRate)) : s->length();
+            v->nFadeStart   = v->nEnd;
+            v->nFadeLength  = 1;
+            v->pNext        = af->pVoices;
+            af->pVoices     = v;
+            ++nVoices;
+        }
+
+        void trigger_kernel::cancel_voices(afile_t *af, size_t fadeout, size_t delay, bool listen)
+        {
+            for (voice_t *v = af->pVoices; v != NULL; v = v->pNext)
+            {
+                // Listen voices and triggered voices are cancelled independently
+                if (v->bListen != listen)
+                    continue;
+
+                // The fade-out is applied to the output, so its length does not depend on the pitch
+                const ssize_t length    = lsp_max(ssize_t(fadeout), ssize_t(1));
+                const ssize_t start     = lsp_max(v->nTime + ssize_t(delay), ssize_t(0));
+                if (start >= v->nFadeStart)
+                    continue;
+
+                v->nFadeStart   = start;
+                v->nFadeLength  = length;
+                v->nEnd         = lsp_min(v->nEnd, start + length);
             }
         }
 
-        void trigger_kernel::cancel_sample(const afile_t *af, size_t fadeout, size_t delay)
+        void trigger_kernel::free_voice(voice_t *v)
         {
-            lsp_trace("id=%d, delay=%d", int(af->nID), int(delay));
+            // The sample replaced in the sample player is retired by the last voice that plays it
+            dspu::Sample *s = v->pSample;
+            if ((s != NULL) && (s->gc_release() == 0))
+                retire_sample(s);
+
+            v->pSample      = NULL;
+            v->pNext        = pFreeVoices;
+            pFreeVoices     = v;
+            --nVoices;
+        }
 
-            // Cancel all playbacks
-            for (size_t i=0; i<nChannels; ++i)
+        void trigger_kernel::drop_voices(afile_t *af)
+        {
+            while (af->pVoices != NULL)
             {
-                lsp_trace("channels[%d].cancel(%d, %d, %d)", int(af->nID), int(i), int(fadeout), int(delay));
-                vChannels[i].cancel_all(af->nID, i, fadeout, delay);
+                voice_t *v      = af->pVoices;
+                af->pVoices     = v->pNext;
+                free_voice(v);
             }
         }
 
-        void trigger_kernel::trigger_on(size_t timestamp, float level)
+        void trigger_kernel::cancel_sample(afile_t *af, size_t fadeout, size_t delay)
+        {
+            lsp_trace("id=%d, delay=%d", int(af->nID), int(delay));
+
+            // Listen previews are not affected by triggers
+            cancel_voices(af, fadeout, delay, false);
+        }
+
+        void trigger_kernel::trigger_on(size_t timestamp, float level, trigger_event_t *event)
         {
             if (nActive <= 0)
                 return;
@@ -831,9 +1361,15 @@ namespace lsp
                 // Apply 'Humanisation' parameters
                 level       = level * ((1.0f - fDynamics*0.5) + fDynamics * sRandom.random(dspu::RND_EXP)) / af->fVelocity;
                 delay      += dspu::millis_to_samples(nSampleRate, fDrift) * sRandom.random(dspu::RND_EXP);
+                const float pitch   = af->fPitch + fPitchVar * (2.0f * sRandom.random(dspu::RND_LINEAR) - 1.0f);
 
                 // Play sample
-                play_sample(af, level, delay);
+                play_sample(af, level, delay, pitch, false);
+                if (event != NULL)
+                {
+                    event->nFile        = af->nID;
+                    event->nDelay       = delay - timestamp;
+                }
 
                 // Trigger the note On indicator
                 af->sNoteOn.blink();
@@ -858,15 +1394,70 @@ namespace lsp
             // Apply changes to all ports
             for (size_t j=0; j<nChannels; ++j)
                 vChannels[j].stop();
+            for (size_t i=0; i<nFiles; ++i)
+                drop_voices(&vFiles[i]);
+        }
+
+        bool trigger_kernel::file_busy(const afile_t *af)
+        {
+            return (af->bBulk) ||
+                (!af->pLoader->idle()) ||
+                (!af->pRenderer->idle()) ||
+                (af->nUpdateReq != af->nUpdateResp);
+        }
+
+        void trigger_kernel::retire_sample(dspu::Sample *s)
+        {
+            if (s == NULL)
+                return;
+
+            // Start the timer when the first sample is retired
+            if (pGCPending == NULL)
+                nGCTimer            = dspu::millis_to_samples(nSampleRate, meta::trigger_metadata::GC_PERIOD);
+
+            nGCBytes           += s->channels() * s->length() * sizeof(float);
+            ++nGCCount;
+            s->gc_link(pGCPending);
+            pGCPending          = s;
+        }
+
+        void trigger_kernel::drop_staged_sample(afile_t *af)
+        {
+            if (!af->bStaged)
+                return;
+
+            // The staged sample is obsolete, it should not be overwritten by the background task
+            // while the audio thread may bind it
+            retire_sample(af->pProcessed);
+            af->pProcessed      = NULL;
+            af->bStaged         = false;
         }
 
         void trigger_kernel::process_file_load_requests()
         {
+            // Commit the loaded kit
+            if (sKitLoader.completed())
+                commit_kit();
+
+            // Renders have higher priority: do not put new loads into the executor queue
+            // ahead of them, loads that are already submitted continue. Continuous edits
+            // of parameters should not block loads forever, so a waiting load is submitted
+            // after a limited number of renders
+            const bool rendering    = (nLoadDefer < meta::trigger_metadata::LOAD_DEFER_RENDERS) && (renders_pending());
+
+            // Load several files requested at the same time as a kit
+            if ((!rendering) && (submit_kit()))
+            {
+                nLoadDefer          = 0;
+                return;
+            }
+
+            bool waiting            = false;
             for (size_t i=0; i<nFiles; ++i)
             {
                 // Get descriptor
                 afile_t *af             = &vFiles[i];
-                if (af->pFile == NULL)
+                if ((af->pFile == NULL) || (af->bBulk))
                     continue;
 
                 // Get path
@@ -877,9 +1468,15 @@ namespace lsp
                 // If there is new load request and loader is idle, then wake up the loader
                 if ((path->pending()) && (af->pLoader->idle()) && (af->pRenderer->idle()))
                 {
+                    waiting             = true;
+                    if (rendering)
+                        continue;
+
                     // Try to submit task
+                    drop_staged_sample(af);
                     if (pExecutor->submit(af->pLoader))
                     {
+                        nLoadDefer          = 0;
                         ++af->nUpdateReq;
                         af->nStatus     = STATUS_LOADING;
                         lsp_trace("successfully submitted loader task");
@@ -892,8 +1489,12 @@ namespace lsp
                     af->nStatus     = af->pLoader->code();
                     af->fLength     = (af->nStatus == STATUS_OK) ? af->pOriginal->duration() * 1000.0f : 0.0f;
 
-                    // Trigger the sample for update and the state for reorder
+                    // Trigger the sample for update and the state for reorder, the newly
+                    // loaded file is always rendered with high quality
                     ++af->nUpdateReq;
+                    af->bCacheReq   = true;
+                    af->bDraftReq   = false;
+                    af->nSettle     = 0;
                     bReorder        = true;
 
                     // Now we can surely commit changes and reset task state
@@ -901,22 +1502,143 @@ namespace lsp
                     af->pLoader->reset();
                 }
             }
+
+            // Renders are counted only while some load is waiting for them
+            if (!waiting)
+                nLoadDefer          = 0;
         }
 
-        void trigger_kernel::process_file_render_requests()
+        bool trigger_kernel::submit_kit()
         {
+            if (!sKitLoader.idle())
+                return false;
+
+            // Collect all files that have been requested for loading
+            nKitFiles           = 0;
             for (size_t i=0; i<nFiles; ++i)
             {
-                // Get descriptor
                 afile_t *af         = &vFiles[i];
-                if (af->pFile == NULL)
+                if ((af->pFile == NULL) || (af->bBulk))
+                    continue;
+
+                plug::path_t *path  = af->pFile->buffer<plug::path_t>();
+                if ((path == NULL) || (!path->pending()))
+                    continue;
+                if ((af->pLoader->idle()) && (af->pRenderer->idle()))
+                    vKitFiles[nKitFiles++]  = af;
+            }
+
+            // Single file is loaded by its own loader
+            if (nKitFiles < 2)
+            {
+                nKitFiles           = 0;
+                return false;
+            }
+
+            // Exclude files from regular processing until the whole kit is loaded
+            for (size_t i=0; i<nKitFiles; ++i)
+            {
+                afile_t *af         = vKitFiles[i];
+                drop_staged_sample(af);
+                af->bBulk           = true;
+                af->nBulkDone       = 0;
+                af->bCache          = true;
+                af->bDraft          = false;
+                af->bDraftReq       = false;
+                af->nSettle         = 0;
+                af->nBulkStatus     = STATUS_OK;
+            }
+            nKitNext            = 0;
+            nKitDone            = 0;
+
+            if (!pExecutor->submit(&sKitLoader))
+            {
+                for (size_t i=0; i<nKitFiles; ++i)
+                    vKitFiles[i]->bBulk = false;
+                nKitFiles           = 0;
+                return false;
+            }
+
+            lsp_trace("successfully submitted kit loader task: files=%d", int(nKitFiles));
+            for (size_t i=0; i<nKitFiles; ++i)
+            {
+                afile_t *af         = vKitFiles[i];
+                af->nUpdateResp     = ++af->nUpdateReq;
+                af->nStatus         = STATUS_LOADING;
+                af->pFile->buffer<plug::path_t>()->accept();
+            }
+
+            return true;
+        }
+
+        void trigger_kernel::commit_kit()
+        {
+            // Fields of files are read only after the worker has published them
+            for (size_t i=0; i<nKitFiles; ++i)
+            {
+                if (!atomic_load(&vKitFiles[i]->nBulkDone))
+                    return;
+            }
+
+            for (size_t i=0; i<nKitFiles; ++i)
+            {
+                afile_t *af         = vKitFiles[i];
+                af->nBulkDone       = 0;
+
+                // Commit the result
+                af->nStatus         = af->nBulkStatus;
+                af->fLength         = ((af->nStatus == STATUS_OK) && (af->pOriginal != NULL)) ? af->pOriginal->duration() * 1000.0f : 0.0f;
+                af->bBulk           = false;
+                af->pFile->buffer<plug::path_t>()->commit();
+
+                // Swap all rendered samples together, files failed to render are rendered again
+                if ((af->pOriginal == NULL) || (af->pProcessed != NULL))
+                    af->bStaged         = true;
+                else
+                    ++af->nUpdateReq;
+                af->bSync           = true;
+            }
+
+            bReorder            = true;
+            nKitFiles           = 0;
+            sKitLoader.reset();
+        }
+
+        void trigger_kernel::process_file_render_requests()
+        {
+            // Files which are being auditioned are submitted first, then all other files
+            for (size_t k=0, n=nFiles*2; k<n; ++k)
+            {
+                // Get descriptor
+                afile_t *af         = &vFiles[k % nFiles];
+                if ((af->pFile == NULL) || (af->bBulk))
+                    continue;
+                if (af->sListen.pending() != (k < nFiles))
                     continue;
 
                 // Get path and check task state
                 if ((af->nUpdateReq != af->nUpdateResp) && (af->pRenderer->idle()) && (af->pLoader->idle()))
                 {
+                    // Renders are never submitted for staged files
+                    drop_staged_sample(af);
+
                     if (af->pOriginal == NULL)
                     {
+                        // There is nothing to render: drop requests for the draft render
+                        af->bDraftReq       = false;
+                        af->nSettle         = 0;
+
+                        if (bAtomicKit)
+                        {
+                            // Unbind the sample together with all other changes of the kit
+                            af->nUpdateResp     = af->nUpdateReq;
+                            af->pProcessed      = NULL;
+                            af->bStaged         = true;
+                            af->bSync           = true;
+                            continue;
+                        }
+
+                        // Playing voices keep the unbound sample until they end
                         af->nUpdateResp     = af->nUpdateReq;
                         af->pProcessed      = NULL;
 
@@ -924,26 +1646,47 @@ namespace lsp
                         for (size_t j=0; j<nChannels; ++j)
                             vChannels[j].unbind(af->nID);
 
+                        af->bStaged         = false;
                         af->bSync           = true;
                     }
-                    else if (pExecutor->submit(af->pRenderer))
+                    else
                     {
                         // Try to submit task
-                        af->nUpdateResp     = af->nUpdateReq;
-                        lsp_trace("successfully submitted renderer task");
+                        af->bDraft          = af->bDraftReq;
+                        af->bCache          = af->bCacheReq;
+                        if (pExecutor->submit(af->pRenderer))
+                        {
+                            ++nLoadDefer;
+                            af->nUpdateResp     = af->nUpdateReq;
+                            af->bDraftReq       = false;
+                            af->bCacheReq       = false;
+                            lsp_trace("successfully submitted renderer task");
+                        }
                     }
                 }
                 else if (af->pRenderer->completed())
                 {
+                    // Schedule the replacement of the draft render
+                    if ((af->bDraft) && (af->pRenderer->code() == STATUS_OK))
+                        af->nSettle         = lsp_max(size_t(dspu::millis_to_samples(nSampleRate, meta::trigger_metadata::SAMPLE_DRAFT_SETTLE)), size_t(1));
+
                     // Commit changes if there is no more pending tasks
-                    if (af->nUpdateReq == af->nUpdateResp)
+                    if ((af->nUpdateReq == af->nUpdateResp) && (bAtomicKit))
+                    {
+                        // Keep the rendered sample until the whole kit is ready
+                        af->bStaged         = true;
+                    }
+                    else if (af->nUpdateReq == af->nUpdateResp)
                     {
-                        // Bind sample for all channels
+                        // Bind sample for all channels, playing voices keep the previous sample until they end
                         for (size_t j=0; j<nChannels; ++j)
                             vChannels[j].bind(af->nID, af->pProcessed);
 
                         // The sample is now under the garbage control inside of the sample player
                         af->pProcessed      = NULL;
+                        af->bStaged         = false;
+                        if (af->nStatus == STATUS_LOADING)
+                            af->nStatus         = STATUS_OK;
                     }
 
                     af->pRenderer->reset();
@@ -952,24 +1695,183 @@ namespace lsp
             }
         }
 
-        void trigger_kernel::process_gc_tasks()
+        void trigger_kernel::process_draft_renders(size_t samples)
+        {
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                afile_t *af         = &vFiles[i];
+                if (af->nSettle <= 0)
+                    continue;
+
+                // Render the sample with high quality when parameters are not changed for a while
+                if (af->nSettle > samples)
+                {
+                    af->nSettle        -= samples;
+                    continue;
+                }
+
+                af->nSettle         = 0;
+                af->bCacheReq       = true;
+                ++af->nUpdateReq;
+            }
+        }
+
+        bool trigger_kernel::renders_pending() const
+        {
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                const afile_t *af   = &vFiles[i];
+                if ((af->pFile == NULL) || (af->bBulk))
+                    continue;
+                if (!af->pRenderer->idle())
+                    return true;
+                if ((af->nUpdateReq != af->nUpdateResp) && (af->pOriginal != NULL) && (af->pLoader->idle()))
+                    return true;
+            }
+
+            return false;
+        }
+
+        size_t trigger_kernel::queue_depth() const
+        {
+            size_t count        = (sGCTask.idle()) ? 0 : 1;
+            if (!sKitLoader.idle())
+                ++count;
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                const afile_t *af   = &vFiles[i];
+                if (af->pFile == NULL)
+                    continue;
+                if (!af->pLoader->idle())
+                    ++count;
+                if (!af->pRenderer->idle())
+                    ++count;
+            }
+
+            return count;
+        }
+
+        bool trigger_kernel::kit_busy() const
+        {
+            if (!sKitLoader.idle())
+                return true;
+
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                const afile_t *af   = &vFiles[i];
+                if (af->pFile == NULL)
+                    continue;
+
+                if (file_busy(af))
+                    return true;
+
+                const plug::path_t *path = af->pFile->buffer<plug::path_t>();
+                if ((path != NULL) && ((path->pending()) || (path->accepted())))
+                    return true;
+            }
+
+            return false;
+        }
+
+        void trigger_kernel::commit_staged_samples()
+        {
+            // Check that there are staged samples
+            bool staged         = false;
+            for (size_t i=0; i<nFiles; ++i)
+                if (vFiles[i].bStaged)
+                {
+                    staged              = true;
+                    break;
+                }
+
+            if (pKitPending != NULL)
+                pKitPending->set_value((staged) ? 1.0f : 0.0f);
+            if (!staged)
+                return;
+
+            // Samples are swapped together with the kit being loaded
+            if (!sKitLoader.idle())
+                return;
+
+            // Wait until all files of the kit are loaded and rendered
+            if ((bAtomicKit) && (kit_busy()))
+                return;
+
+            // Swap all samples within the same block, replaced samples are passed to the garbage collector
+            // when their voices end. Staged files which have background tasks or pending updates are not committed
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                afile_t *af         = &vFiles[i];
+                if ((!af->bStaged) || (file_busy(af)))
+                    continue;
+
+                for (size_t j=0; j<nChannels; ++j)
+                {
+                    if (af->pProcessed != NULL)
+                        vChannels[j].bind(af->nID, af->pProcessed);
+                    else
+                        vChannels[j].unbind(af->nID);
+                }
+
+                // The sample is now under the garbage control inside of the sample player
+                af->pProcessed      = NULL;
+                af->bStaged         = false;
+                af->bSync           = true;
+                if (af->nStatus == STATUS_LOADING)
+                    af->nStatus         = STATUS_OK;
+            }
+
+            // Update the indicator, busy files may remain staged
+            staged              = false;
+            for (size_t i=0; i<nFiles; ++i)
+                staged              = staged || vFiles[i].bStaged;
+            if (pKitPending != NULL)
+                pKitPending->set_value((staged) ? 1.0f : 0.0f);
+        }
+
+        void trigger_kernel::process_gc_tasks(size_t samples)
         {
             if (sGCTask.completed())
                 sGCTask.reset();
 
-            if (sGCTask.idle())
+            // Collect retired samples of all channels into one chain
+            for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX; ++i)
             {
-                // Obtain the list of samples for destroy
-                if (pGCList == NULL)
+                dspu::Sample *list  = vChannels[i].gc();
+                while (list != NULL)
                 {
-                    for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX; ++i)
-                        if ((pGCList = vChannels[i].gc()) != NULL)
-                            break;
+                    dspu::Sample *next  = list->gc_next();
+                    retire_sample(list);
+                    list                = next;
                 }
+            }
+
+            if (pGCPending == NULL)
+                return;
+            nGCTimer    = (nGCTimer > samples) ? nGCTimer - samples : 0;
+
+            // Submit the garbage collection when there is enough garbage or it is held for too long,
+            // it has the lowest priority and waits for loads and renders unless there is too much garbage
+            if ((!sGCTask.idle()) || (pGCList != NULL))
+                return;
+            if ((nGCBytes < meta::trigger_metadata::GC_BATCH_BYTES) && (queue_depth() > 0))
+                return;
+            if ((nGCCount < meta::trigger_metadata::GC_BATCH_SIZE) &&
+                (nGCBytes < meta::trigger_metadata::GC_BATCH_BYTES) &&
+                (nGCTimer > 0))
+                return;
 
-                if (pGCList != NULL)
-                    pExecutor->submit(&sGCTask);
+            pGCList     = pGCPending;
+            if (!pExecutor->submit(&sGCTask))
+            {
+                pGCList     = NULL;
+                return;
             }
+
+            pGCPending  = NULL;
+            nGCCount    = 0;
+            nGCBytes    = 0;
+            nGCTimer    = 0;
         }
 
         void trigger_kernel::reorder_samples()
@@ -1012,44 +1914,14 @@ namespace lsp
         {
             lsp_trace("id=%d", int(af->nID));
 
-            // Obtain the sample that will be used for playback
-            dspu::Sample *s = vChannels[0].get(af->nID);
-            if (s == NULL)
-                return;
-
-            // Scale the final output gain
-            const float gain    = af->fMakeup;
-            size_t index        = 0;
-
-            dspu::PlaySettings ps;
-
-            if (nChannels == 1)
-            {
-                ps.set_channel(af->nID, 0);
-                ps.set_playback(0, 0, gain * af->fGains[0]);
-                af->vPlaybacks[index++]     = vChannels[0].play(&ps);
-            }
-            else
-            {
-                ps.set_channel(af->nID, 0);
-                ps.set_playback(0, 0, gain * af->fGains[0]);
-                af->vPlaybacks[index++]     = vChannels[0].play(&ps);
-                ps.set_playback(0, 0, gain * (1.0f - af->fGains[0]));
-                af->vPlaybacks[index++]     = vChannels[1].play(&ps);
-
-                ps.set_channel(af->nID, 1);
-                ps.set_playback(0, 0, gain * (1.0f - af->fGains[1]));
-                af->vPlaybacks[index++]     = vChannels[0].play(&ps);
-                ps.set_playback(0, 0, gain * af->fGains[1]);
-                af->vPlaybacks[index++]     = vChannels[1].play(&ps);
-            }
+            // The listen preview is played by the voice exactly as the triggered sample
+            play_sample(af, 1.0f, 0, af->fPitch, true);
         }
 
         void trigger_kernel::cancel_listen(afile_t *af)
         {
             const size_t fadeout = dspu::millis_to_samples(nSampleRate, 5);
-            for (size_t i=0; i<4; ++i)
-                af->vPlaybacks[i].cancel(fadeout, 0);
+            cancel_voices(af, fadeout, 0, true);
         }
 
         void trigger_kernel::process_listen_events()
@@ -1081,29 +1953,212 @@ namespace lsp
             }
         }
 
-        void trigger_kernel::play_samples(float **outs, const float **ins, size_t samples)
+        size_t trigger_kernel::resample_voice(voice_t *v, const float **dst, size_t samples)
         {
-            if (ins != NULL)
+            dspu::Sample *s         = v->pSample;
+            const size_t s_channels = s->channels();
+            const ssize_t length    = s->length();
+            const double rate       = v->fRate;
+            const ssize_t offset    = v->nOffset;
+            const double frac       = v->fFrac;
+
+            // Limit the block by the buffer size and the end of the sample
+            const double remain     = (double(length - offset) - frac) / rate;
+            size_t to_do            = lsp_min(samples, meta::trigger_metadata::BUFFER_SIZE);
+            to_do                   = lsp_min(to_do, lsp_max(size_t(ceil(remain)), size_t(1)));
+
+            // Resample all channels of the block into the buffer
+            float *buf[meta::trigger_metadata::TRACKS_MAX];
+            const float *src[meta::trigger_metadata::TRACKS_MAX];
+            for (size_t i=0; i<s_channels; ++i)
             {
-                for (size_t i=0; i<nChannels; ++i)
-                    vChannels[i].process(outs[i], ins[i], samples, dspu::SAMPLER_ALL);
+                buf[i]                  = &vBuffer[i * meta::trigger_metadata::BUFFER_SIZE];
+                src[i]                  = s->channel(i);
+                dst[i]                  = buf[i];
+            }
+
+            compute_positions(vIndex, vFrac, offset, frac, rate, to_do);
+            if (rate > 1.0)
+            {
+                // Raising the pitch requires band limiting to prevent aliasing
+                interpolate_aa(buf, src, s_channels, length, vIndex, vFrac, vTaps, rate, to_do, vAAKernel);
             }
             else
             {
-                for (size_t i=0; i<nChannels; ++i)
-                    vChannels[i].process(outs[i], samples, dspu::SAMPLER_ALL);
+                for (size_t i=0; i<s_channels; ++i)
+                    interpolate(buf[i], src[i], length, vIndex, vFrac, vTaps, to_do);
+            }
+
+            // Advance the position
+            const double pos        = frac + to_do * rate;
+            const size_t advance    = size_t(pos);
+            v->nOffset              = offset + advance;
+            v->fFrac                = pos - advance;
+
+            return to_do;
+        }
+
+        bool trigger_kernel::mix_voice(voice_t *v, float **outs, size_t samples)
+        {
+            dspu::Sample *s         = v->pSample;
+            const size_t s_channels = s->channels();
+            const ssize_t length    = s->length();
+            ssize_t time            = v->nTime;
+            size_t done             = 0;
+
+            // Skip the delay
+            if (time < 0)
+            {
+                done                    = lsp_min(size_t(-time), samples);
+                time                   += done;
+            }
+
+            const float *src[meta::trigger_metadata::TRACKS_MAX];
+            while ((done < samples) && (time < v->nEnd) && (v->nOffset < length))
+            {
+                // Fade-out is computed in output samples, so the block does not cross its start
+                const ssize_t boundary  = (time < v->nFadeStart) ? v->nFadeStart : v->nEnd;
+                size_t to_do            = lsp_min(samples - done, size_t(boundary - time));
+
+                // Pitched voice is resampled into the buffer, otherwise the sample data is mixed directly
+                if (v->fRate != 1.0f)
+                    to_do                   = resample_voice(v, src, to_do);
+                else
+                {
+                    to_do                   = lsp_min(to_do, size_t(length - v->nOffset));
+                    for (size_t i=0; i<s_channels; ++i)
+                        src[i]                  = &s->channel(i)[v->nOffset];
+                    v->nOffset             += to_do;
+                }
+
+                if (time < v->nFadeStart)
+                {
+                    // Constant gain part of the sample
+                    for (size_t i=0; i<s_channels; ++i)
+                    {
+                        for (size_t j=0; j<nChannels; ++j)
+                        {
+                            const float gain        = v->vGains[i][j] * fGain;
+                            if (gain != 0.0f)
+                                dsp::fmadd_k3(&outs[j][done], src[i], gain, to_do);
+                        }
+                    }
+                }
+                else
+                {
+                    // Fade-out part of the sample
+                    const float k           = 1.0f / v->nFadeLength;
+                    const float k1          = 1.0f - (time - v->nFadeStart) * k;
+                    const float k2          = 1.0f - (time + to_do - v->nFadeStart) * k;
+                    for (size_t i=0; i<s_channels; ++i)
+                    {
+                        for (size_t j=0; j<nChannels; ++j)
+                        {
+                            const float gain        = v->vGains[i][j] * fGain;
+                            if (gain != 0.0f)
+                                dsp::lramp_add2(&outs[j][done], src[i], gain * k1, gain * k2, to_do);
+                        }
+                    }
+                }
+
+                time                   += to_do;
+                done                   += to_do;
+            }
+
+            v->nTime                = time;
+            return (time < v->nEnd) && (v->nOffset < length);
+        }
+
+        void trigger_kernel::mix_voices(float **outs, size_t samples)
+        {
+            if (nVoices <= 0)
+                return;
+
+            // Voices are grouped by the file, so all voices that read the same sample
+            // are processed together
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                afile_t *af             = &vFiles[i];
+                for (voice_t **pv = &af->pVoices; *pv != NULL; )
+                {
+                    voice_t *v              = *pv;
+                    if (mix_voice(v, outs, samples))
+                    {
+                        pv                      = &v->pNext;
+                        continue;
+                    }
+
+                    // Return the voice to the pool
+                    *pv                     = v->pNext;
+                    free_voice(v);
+                }
+            }
+        }
+
+        void trigger_kernel::play_samples(float **outs, const float **ins, size_t samples)
+        {
+            // Prepare the output buffer
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                if (ins == NULL)
+                    dsp::fill_zero(outs[i], samples);
+                else if (ins[i] == NULL)
+                    dsp::fill_zero(outs[i], samples);
+                else if (ins[i] != outs[i])
+                    dsp::copy(outs[i], ins[i], samples);
             }
+
+            // Mix triggered voices and listen previews
+            mix_voices(outs, samples);
         }
 
         void trigger_kernel::process(float **outs, const float **ins, size_t samples)
         {
-            process_file_load_requests();
+            process_draft_renders(samples);
             process_file_render_requests();
-            process_gc_tasks();
+            process_file_load_requests();
+            commit_staged_samples();
+            process_gc_tasks(samples);
             reorder_samples();
             process_listen_events();
+            if (pProfiler != NULL)
+                pProfiler->end(TriggerProfiler::ST_HOUSEKEEPING);
+
             play_samples(outs, ins, samples);
+            if (pProfiler != NULL)
+                pProfiler->end(TriggerProfiler::ST_VOICES);
+
+            output_parameters(samples);
+            if (pProfiler != NULL)
+                pProfiler->end(TriggerProfiler::ST_HOUSEKEEPING);
+        }
+
+        void trigger_kernel::process_idle(size_t samples)
+        {
+            process_draft_renders(samples);
+            process_file_render_requests();
+            process_file_load_requests();
+            commit_staged_samples();
+            process_gc_tasks(samples);
+            reorder_samples();
+            process_listen_events();
             output_parameters(samples);
+            if (pProfiler != NULL)
+                pProfiler->end(TriggerProfiler::ST_HOUSEKEEPING);
+        }
+
+        bool trigger_kernel::idle() const
+        {
+            if (nVoices > 0)
+                return false;
+
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                if (vFiles[i].sListen.pending())
+                    return false;
+            }
+
+            return true;
         }
 
         void trigger_kernel::output_parameters(size_t samples)
@@ -1111,6 +2166,10 @@ namespace lsp
             // Update activity led output
             if (pActivity != NULL)
                 pActivity->set_value(sActivity.process(samples));
+            if (pQueueDepth != NULL)
+                pQueueDepth->set_value(queue_depth());
+            if (pKitProgress != NULL)
+                pKitProgress->set_value((nKitFiles > 0) ? 100.0f * atomic_load(&nKitDone) / nKitFiles : 0.0f);
 
             for (size_t i=0; i<nFiles; ++i)
             {
@@ -1133,7 +2192,7 @@ namespace lsp
 
                 // Store file thumbnails to mesh
                 plug::mesh_t *mesh  = reinterpret_cast<plug::mesh_t *>(af->pMesh->buffer());
-                if ((mesh == NULL) || (!mesh->isEmpty()) || (!af->bSync) || (!af->pLoader->idle()) || (!af->pRenderer->idle()))
+                if ((mesh == NULL) || (!mesh->isEmpty()) || (!af->bSync) || (af->bBulk) || (!af->pLoader->idle()) || (!af->pRenderer->idle()))
                     continue;
 
                 if ((channels > 0) && (af->vThumbs[0] != NULL))
@@ -1160,14 +2219,25 @@ namespace lsp
             v->write_object("sStop", &f->sStop);
             v->write_object("sNoteOn", &f->sNoteOn);
             v->write_object("pOriginal", f->pOriginal);
+            v->write_object("pResampled", f->pResampled);
             v->write_object("pProcessed", f->pProcessed);
+            v->write("nSource", f->nSource);
             v->write("vThumbs", f->vThumbs);
 
-            v->write_object_array("vPlaybacks", f->vPlaybacks, 4);
+            v->write("pVoices", f->pVoices);
 
             v->write("nUpdateReq", f->nUpdateReq);
             v->write("nUpdateResp", f->nUpdateResp);
             v->write("bSync", f->bSync);
+            v->write("bStaged", f->bStaged);
+            v->write("bDraft", f->bDraft);
+            v->write("bDraftReq", f->bDraftReq);
+            v->write("nSettle", f->nSettle);
+            v->write("bCache", f->bCache);
+            v->write("bCacheReq", f->bCacheReq);
+            v->write("bBulk", f->bBulk);
+            v->write("nBulkStatus", f->nBulkStatus);
+            v->write("nBulkDone", f->nBulkDone);
             v->write("fVelocity", f->fVelocity);
             v->write("fPitch", f->fPitch);
             v->write("fHeadCut", f->fHeadCut);
@@ -1206,7 +2276,12 @@ namespace lsp
         void trigger_kernel::dump(dspu::IStateDumper *v) const
         {
             v->write("pExecutor", pExecutor);
-            v->write("pGCList", pExecutor);
+            v->write("pProfiler", pProfiler);
+            v->write("pGCList", pGCList);
+            v->write("pGCPending", pGCPending);
+            v->write("nGCCount", nGCCount);
+            v->write("nGCBytes", nGCBytes);
+            v->write("nGCTimer", nGCTimer);
             v->begin_array("vFiles", vFiles, nFiles);
             {
                 for (size_t i=0; i<nFiles; ++i)
@@ -1219,26 +2294,49 @@ namespace lsp
             v->end_array();
 
             v->writev("vActive", vActive, nActive);
+            v->write("vVoices", vVoices);
+            v->write("pFreeVoices", pFreeVoices);
 
             v->write_object_array("vChannels", vChannels, meta::trigger_metadata::TRACKS_MAX);
             v->write_object_array("vBypass", vBypass, meta::trigger_metadata::TRACKS_MAX);
             v->write_object("sActivity", &sActivity);
             v->write_object("sRandom", &sRandom);
             v->write_object("sGCTask", &sGCTask);
+            v->write_object("sKitLoader", &sKitLoader);
+            v->writev("vKitFiles", vKitFiles, nKitFiles);
+            v->write("nKitFiles", nKitFiles);
+            v->write("nKitNext", nKitNext);
+            v->write("nKitDone", nKitDone);
+            v->write("nLoadDefer", nLoadDefer);
+            v->write_object("sCache", &sCache);
+            v->write("nCacheState", nCacheState);
 
             v->write("nFiles", nFiles);
             v->write("nActive", nActive);
             v->write("nChannels", nChannels);
+            v->write("nVoices", nVoices);
             v->write("vBuffer", vBuffer);
+            v->write("vIndex", vIndex);
+            v->write("vFrac", vFrac);
+            v->write("vTaps", vTaps);
+            v->write("vAAKernel", vAAKernel);
             v->write("bBypass", bBypass);
             v->write("bReorder", bReorder);
+            v->write("bAtomicKit", bAtomicKit);
             v->write("fFadeout", fFadeout);
             v->write("fDynamics", fDynamics);
             v->write("fDrift", fDrift);
+            v->write("fPitchVar", fPitchVar);
+            v->write("fGain", fGain);
             v->write("nSampleRate", nSampleRate);
 
             v->write("pDynamics", pDynamics);
             v->write("pDrift", pDrift);
+            v->write("pKitSwitch", pKitSwitch);
+            v->write("pKitPending", pKitPending);
+            v->write("pPitchVar", pPitchVar);
+            v->write("pQueueDepth", pQueueDepth);
+            v->write("pKitProgress", pKitProgress);
             v->write("pActivity", pActivity);
             v->write("pData", pData);
         }
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/runtime/system.h>
+
+#include <private/plugins/trigger_profiler.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        TriggerProfiler::TriggerProfiler()
+        {
+            for (size_t i=0; i<ST_TOTAL; ++i)
+            {
+                vBlock[i]       = 0;
+                vLast[i]        = 0;
+                vPeak[i]        = 0;
+                vOverall[i]     = 0;
+            }
+            nStamp          = 0;
+            nBlocks         = 0;
+            nSamples        = 0;
+            bEnabled        = false;
+        }
+
+        TriggerProfiler::~TriggerProfiler()
+        {
+        }
+
+        wsize_t TriggerProfiler::now()
+        {
+            system::time_t ts;
+            system::get_time(&ts);
+            return wsize_t(ts.seconds) * 1000000000 + ts.nanos;
+        }
+
+        void TriggerProfiler::set_enabled(bool enabled)
+        {
+            if (bEnabled == enabled)
+                return;
+
+            bEnabled        = enabled;
+            if (!bEnabled)
+                return;
+
+            // Reset statistics
+            for (size_t i=0; i<ST_TOTAL; ++i)
+            {
+                vBlock[i]       = 0;
+                vLast[i]        = 0;
+                vPeak[i]        = 0;
+                vOverall[i]     = 0;
+            }
+            nBlocks         = 0;
+            nSamples        = 0;
+        }
+
+        void TriggerProfiler::commit(size_t samples)
+        {
+            if (!bEnabled)
+                return;
+
+            for (size_t i=0; i<ST_TOTAL; ++i)
+            {
+                const wsize_t t = vBlock[i];
+                vLast[i]        = t;
+                vPeak[i]        = lsp_max(vPeak[i], t);
+                vOverall[i]    += t;
+                vBlock[i]       = 0;
+            }
+            ++nBlocks;
+            nSamples       += samples;
+        }
+
+        double TriggerProfiler::throughput() const
+        {
+            wsize_t total   = 0;
+            for (size_t i=0; i<ST_TOTAL; ++i)
+                total          += vOverall[i];
+
+            return (total > 0) ? double(nSamples) * 1e+9 / double(total) : 0.0;
+        }
+
+        void TriggerProfiler::dump(dspu::IStateDumper *v) const
+        {
+            v->writev("vBlock", vBlock, ST_TOTAL);
+            v->writev("vLast", vLast, ST_TOTAL);
+            v->writev("vPeak", vPeak, ST_TOTAL);
+            v->writev("vOverall", vOverall, ST_TOTAL);
+            v->write("nStamp", nStamp);
+            v->write("nBlocks", nBlocks);
+            v->write("nSamples", nSamples);
+            v->write("fThroughput", throughput());
+            v->write("bEnabled", bEnabled);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
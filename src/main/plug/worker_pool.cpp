@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/ipc/Thread.h>
+
+#include <private/plugins/worker_pool.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static uatomic_t helpers_busy       = 0;
+
+        size_t WorkerPool::limit()
+        {
+            // Leave one core to the threads which have started jobs
+            const size_t cores      = ipc::Thread::system_cores();
+            return (cores > 1) ? cores - 1 : 1;
+        }
+
+        size_t WorkerPool::acquire(size_t count)
+        {
+            const size_t max        = limit();
+            while (true)
+            {
+                const uatomic_t busy    = atomic_load(&helpers_busy);
+                const size_t avail      = (busy < max) ? max - busy : 0;
+                const size_t n          = lsp_min(count, avail);
+                if (n <= 0)
+                    return 0;
+                if (atomic_cas(&helpers_busy, busy, uatomic_t(busy + n)))
+                    return n;
+            }
+        }
+
+        void WorkerPool::release(size_t count)
+        {
+            if (count <= 0)
+                return;
+
+            while (true)
+            {
+                const uatomic_t busy    = atomic_load(&helpers_busy);
+                if (atomic_cas(&helpers_busy, busy, uatomic_t(busy - count)))
+                    return;
+            }
+        }
+
+        status_t WorkerPool::helper(void *arg)
+        {
+            dsp::context_t ctx;
+            dsp::start(&ctx);
+            lsp_finally { dsp::finish(&ctx); };
+
+            const job_t *job    = static_cast<const job_t *>(arg);
+            job->pWorker(job->pArg);
+            return STATUS_OK;
+        }
+
+        size_t WorkerPool::run(worker_t worker, void *arg, size_t threads)
+        {
+            job_t job;
+            job.pWorker             = worker;
+            job.pArg                = arg;
+
+            // Take helper threads from the global budget, the rest of the work is done by the caller
+            const size_t helpers    = (threads > 1) ? acquire(lsp_min(threads - 1, HELPERS_MAX)) : 0;
+            ipc::Thread *vThreads[HELPERS_MAX];
+            size_t nthreads         = 0;
+            for (size_t i=0; i<helpers; ++i)
+            {
+                ipc::Thread *t          = new ipc::Thread(helper, &job);
+                if (t->start() != STATUS_OK)
+                {
+                    delete t;
+                    break;
+                }
+                vThreads[nthreads++]    = t;
+            }
+            release(helpers - nthreads);
+
+            worker(arg);
+
+            for (size_t i=0; i<nthreads; ++i)
+            {
+                vThreads[i]->join();
+                delete vThreads[i];
+            }
+            release(nthreads);
+
+            return nthreads + 1;
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -22,6 +22,7 @@
 #include <private/plugins/trigger.h>
 #include <private/ui/trigger.h>
 #include <lsp-plug.in/plug-fw/ui.h>
+#include <private/ui/trigger_history.h>
 #include <private/ui/trigger_midi.h>
 
 namespace lsp
@@ -49,12 +50,39 @@ namespace lsp
         // Trigger UI implementation
         trigger::trigger(const meta::plugin_t *meta): ui::Module(meta)
         {
+            pApplyCalibration   = NULL;
+            for (size_t i=0; i<4; ++i)
+            {
+                vCalibration[i].pSource = NULL;
+                vCalibration[i].pTarget = NULL;
+            }
+            pEventLog           = NULL;
+            for (size_t i=0; i<trigger_events::F_TOTAL; ++i)
+                vLastHit[i]         = NULL;
         }
 
         trigger::~trigger()
         {
         }
 
+        typedef struct history_mesh_t
+        {
+            const char                 *id;
+            const char                 *mesh_id;
+            const char                 *proxy_id;
+            trigger_history::history_t  type;
+        } history_mesh_t;
+
+        static const history_mesh_t history_meshes[] =
+        {
+            { "isgd",   "isg",      "isgh",     trigger_history::H_INPUT    },
+            { "isgld",  "isgl",     "isglh",    trigger_history::H_INPUT    },
+            { "isgrd",  "isgr",     "isgrh",    trigger_history::H_INPUT    },
+            { "tfgd",   "tfg",      "tfgh",     trigger_history::H_FUNCTION },
+            { "tlgd",   "tlg",      "tlgh",     trigger_history::H_VELOCITY },
+            { NULL,     NULL,       NULL,       trigger_history::H_FUNCTION }
+        };
+
         status_t trigger::init(ui::IWrapper *wrapper)
         {
             status_t res = ui::Module::init(wrapper);
@@ -89,7 +117,87 @@ namespace lsp
                 }
             }
 
+            // Bind calibration ports
+            static const char *calibration_ports[] =
+            {
+                "cdl", "dl",
+                "crrl", "rrl",
+                "cdtr1", "dtr1",
+                "cdtr2", "dtr2"
+            };
+
+            pApplyCalibration   = wrapper->port("capp");
+            for (size_t i=0; i<4; ++i)
+            {
+                vCalibration[i].pSource = wrapper->port(calibration_ports[i*2]);
+                vCalibration[i].pTarget = wrapper->port(calibration_ports[i*2 + 1]);
+            }
+
+            // Create proxy ports that restore complete history meshes from incremental updates
+            for (const history_mesh_t *h = history_meshes; h->id != NULL; ++h)
+            {
+                ui::IPort *port = wrapper->port(h->id);
+                ui::IPort *full = wrapper->port(h->mesh_id);
+                if ((port == NULL) || (full == NULL))
+                    continue;
+
+                trigger_history::HistoryMeshPort *mesh = new trigger_history::HistoryMeshPort();
+                if (mesh == NULL)
+                    return STATUS_NO_MEM;
+                if ((res = mesh->init(h->proxy_id, port, full->metadata(), h->type)) != STATUS_OK)
+                {
+                    delete mesh;
+                    return res;
+                }
+                if ((res = pWrapper->bind_custom_port(mesh)) != STATUS_OK)
+                {
+                    delete mesh;
+                    return res;
+                }
+            }
+
+            // Create ports that show the last hit from the event log
+            pEventLog           = wrapper->port("tevl");
+            if (pEventLog != NULL)
+            {
+                for (size_t i=0; i<trigger_events::F_TOTAL; ++i)
+                {
+                    trigger_events::LastHitPort *p = new trigger_events::LastHitPort(trigger_events::hit_field_t(i));
+                    if (p == NULL)
+                        return STATUS_NO_MEM;
+                    if ((res = pWrapper->bind_custom_port(p)) != STATUS_OK)
+                    {
+                        delete p;
+                        return res;
+                    }
+                    vLastHit[i]         = p;
+                }
+            }
+
             return STATUS_OK;
         }
+
+        void trigger::apply_calibration()
+        {
+            for (size_t i=0; i<4; ++i)
+            {
+                calibration_t *c    = &vCalibration[i];
+                if ((c->pSource == NULL) || (c->pTarget == NULL))
+                    continue;
+
+                c->pTarget->set_value(c->pSource->value());
+                c->pTarget->notify_all(ui::PORT_USER_EDIT);
+            }
+        }
+
+        void trigger::notify(ui::IPort *port, size_t flags)
+        {
+            ui::Module::notify(port, flags);
+
+            if ((port != NULL) && (port == pApplyCalibration) && (port->value() >= 0.5f))
+                apply_calibration();
+            if ((port != NULL) && (port == pEventLog))
+                trigger_events::update_last_hit(vLastHit, pEventLog);
+        }
     } /* namespace plugui */
 } /* namespace lsp */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/plug-fw/meta/ports.h>
+
+#include <private/meta/trigger.h>
+#include <private/ui/trigger_events.h>
+
+namespace lsp
+{
+    namespace meta
+    {
+        static const meta::port_t last_hit_templates[] =
+        {
+            CONTROL_ALL("lhl", "Last hit level", "Hit level", U_GAIN_AMP, 0.0f, GAIN_AMP_P_24_DB, 0.0f, 0.01f),
+            CONTROL_ALL("lhv", "Last hit velocity", "Hit vel", U_PERCENT, 0.0f, 100.0f, 0.0f, 0.1f),
+            INT_CONTROL_ALL("lhs", "Last hit sample", "Hit sample", U_NONE, 0.0f, trigger_metadata::SAMPLE_FILES, 0.0f, 1.0f),
+            CONTROL_ALL("lhd", "Last hit delay", "Hit delay", U_MSEC, 0.0f, 1000.0f, 0.0f, 0.1f),
+        };
+
+    } /* namespace meta */
+
+    namespace plugui
+    {
+        namespace trigger_events
+        {
+            LastHitPort::LastHitPort(hit_field_t field):
+                ui::IPort(&meta::last_hit_templates[field])
+            {
+                fValue          = 0.0f;
+            }
+
+            LastHitPort::~LastHitPort()
+            {
+            }
+
+            float LastHitPort::value()
+            {
+                return fValue;
+            }
+
+            void LastHitPort::set_value(float value)
+            {
+                fValue          = value;
+            }
+
+            void update_last_hit(LastHitPort **ports, ui::IPort *log)
+            {
+                // The event log mesh contains: age, level, velocity, file index and delay of each event
+                const plug::mesh_t *mesh = (log != NULL) ? log->buffer<plug::mesh_t>() : NULL;
+                if ((mesh == NULL) || (mesh->nBuffers < 5) || (mesh->nItems <= 0))
+                    return;
+
+                const size_t last   = mesh->nItems - 1;
+                float values[F_TOTAL];
+                values[F_LEVEL]     = mesh->pvData[1][last];
+                values[F_VELOCITY]  = mesh->pvData[2][last] * 100.0f;
+                values[F_SAMPLE]    = mesh->pvData[3][last] + 1.0f;     // Zero means no sample
+                values[F_DELAY]     = mesh->pvData[4][last];
+
+                for (size_t i=0; i<F_TOTAL; ++i)
+                {
+                    LastHitPort *p      = ports[i];
+                    if (p == NULL)
+                        continue;
+                    p->set_value(values[i]);
+                    p->notify_all(ui::PORT_NONE);
+                }
+            }
+
+        } /* namespace trigger_events */
+    } /* namespace plugui */
+} /* namespace lsp */
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/meta/trigger.h>
+#include <private/ui/trigger_history.h>
+
+namespace lsp
+{
+    namespace plugui
+    {
+        namespace trigger_history
+        {
+            static constexpr size_t MESH_SIZE       = meta::trigger_metadata::HISTORY_MESH_SIZE;
+            static constexpr size_t MESH_ITEMS      = MESH_SIZE + 4;
+
+            HistoryMeshPort::HistoryMeshPort()
+            {
+                enType          = H_FUNCTION;
+                nHead           = 0;
+                vRing           = NULL;
+                pMesh           = NULL;
+                pData           = NULL;
+            }
+
+            HistoryMeshPort::~HistoryMeshPort()
+            {
+                vRing           = NULL;
+                pMesh           = NULL;
+                free_aligned(pData);
+            }
+
+            status_t HistoryMeshPort::init(const char *id, ui::IPort *port, const meta::port_t *tpl, history_t type)
+            {
+                if ((port == NULL) || (tpl == NULL))
+                    return STATUS_BAD_ARGUMENTS;
+
+                // Allocate ring buffer and mesh with two buffers
+                const size_t szof_ring  = align_size(MESH_SIZE * sizeof(float), DEFAULT_ALIGN);
+                const size_t szof_mesh  = align_size(sizeof(plug::mesh_t) + 2 * sizeof(float *), DEFAULT_ALIGN);
+                const size_t szof_buf   = align_size(MESH_ITEMS * sizeof(float), DEFAULT_ALIGN);
+                const size_t allocate   = szof_ring + szof_mesh + szof_buf * 2;
+
+                uint8_t *ptr            = alloc_aligned<uint8_t>(pData, allocate);
+                if (ptr == NULL)
+                    return STATUS_NO_MEM;
+                bzero(ptr, allocate);
+
+                enType                  = type;
+                nHead                   = 0;
+                vRing                   = advance_ptr_bytes<float>(ptr, szof_ring);
+                pMesh                   = advance_ptr_bytes<plug::mesh_t>(ptr, szof_mesh);
+                pMesh->pvData[0]        = advance_ptr_bytes<float>(ptr, szof_buf);
+                pMesh->pvData[1]        = advance_ptr_bytes<float>(ptr, szof_buf);
+
+                build_mesh();
+
+                return ProxyPort::init(id, port, tpl);
+            }
+
+            void HistoryMeshPort::build_mesh()
+            {
+                // The horizontal axis of the graph always spans HISTORY_TIME divisions,
+                // the time labels of divisions are scaled according to the zoom
+                const float step    = meta::trigger_metadata::HISTORY_TIME / MESH_SIZE;
+                const size_t skip   = (enType == H_INPUT) ? 1 : (enType == H_VELOCITY) ? 2 : 0;
+                float *x            = &pMesh->pvData[0][skip];
+                float *y            = &pMesh->pvData[1][skip];
+
+                // Unroll the ring, the oldest dot goes first
+                for (size_t i=0; i<MESH_SIZE; ++i)
+                {
+                    x[i]                = (MESH_SIZE - i - 1) * step;
+                    y[i]                = vRing[(nHead + i) % MESH_SIZE];
+                }
+
+                // Add the edge points
+                x                   = pMesh->pvData[0];
+                y                   = pMesh->pvData[1];
+                switch (enType)
+                {
+                    case H_INPUT:
+                        x[0]                = x[1];
+                        y[0]                = 0.0f;
+                        x[MESH_SIZE + 1]    = x[MESH_SIZE];
+                        y[MESH_SIZE + 1]    = 0.0f;
+                        pMesh->data(2, MESH_SIZE + 2);
+                        break;
+
+                    case H_VELOCITY:
+                        x[0]                = x[2] + 0.5f;
+                        x[1]                = x[0];
+                        y[0]                = 0.0f;
+                        y[1]                = y[2];
+
+                        x                  += MESH_SIZE + 2;
+                        y                  += MESH_SIZE + 2;
+
+                        x[0]                = x[-1] - 0.5f;
+                        y[0]                = y[-1];
+                        x[1]                = x[0];
+                        y[1]                = 0.0f;
+                        pMesh->data(2, MESH_SIZE + 4);
+                        break;
+
+                    default:
+                        pMesh->data(2, MESH_SIZE);
+                        break;
+                }
+            }
+
+            void *HistoryMeshPort::buffer()
+            {
+                return pMesh;
+            }
+
+            void HistoryMeshPort::notify(ui::IPort *port, size_t flags)
+            {
+                // Apply the delta: first buffer contains values, second buffer contains positions in the ring
+                plug::mesh_t *delta = static_cast<plug::mesh_t *>(ProxyPort::buffer());
+                if ((delta != NULL) && (delta->nBuffers >= 2) && (delta->nItems > 0))
+                {
+                    const float *v      = delta->pvData[0];
+                    const float *p      = delta->pvData[1];
+                    size_t pos          = 0;
+
+                    for (size_t i=0; i<delta->nItems; ++i)
+                    {
+                        pos                 = size_t(p[i]) % MESH_SIZE;
+                        vRing[pos]          = v[i];
+                    }
+                    nHead               = (pos + 1) % MESH_SIZE;
+
+                    build_mesh();
+                }
+
+                ProxyPort::notify(port, flags);
+            }
+
+        } /* namespace trigger_history */
+    } /* namespace plugui */
+} /* namespace lsp */
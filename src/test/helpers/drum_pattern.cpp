@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/stdlib/math.h>
+
+#include "drum_pattern.h"
+
+namespace lsp
+{
+    namespace test
+    {
+        DrumPattern::DrumPattern(size_t sample_rate, uint32_t seed)
+        {
+            vData           = NULL;
+            nLength         = 0;
+            nSampleRate     = sample_rate;
+            nSeed           = seed;
+        }
+
+        DrumPattern::~DrumPattern()
+        {
+            clear();
+        }
+
+        float DrumPattern::random()
+        {
+            // Linear congruential generator, the sequence does not depend on the platform
+            nSeed           = nSeed * 1664525u + 1013904223u;
+            return (nSeed >> 8) * (1.0f / 16777216.0f);
+        }
+
+        bool DrumPattern::add(size_t onset, float amp, float decay, float freq, bool target)
+        {
+            drum_hit_t *h   = vHits.add();
+            if (h == NULL)
+                return false;
+
+            h->nOnset       = onset;
+            h->fAmp         = amp;
+            h->fDecay       = decay;
+            h->fFreq        = freq;
+            h->bTarget      = target;
+
+            return true;
+        }
+
+        bool DrumPattern::add_random(size_t length, float density, float amp_min, float amp_max, float decay)
+        {
+            // Keep the hits apart enough for the trigger to release between them
+            const size_t gap    = nSampleRate * decay * 0.008f;
+            const size_t period = nSampleRate / density;
+            for (size_t pos = gap; pos < length; )
+            {
+                const float amp     = amp_min + (amp_max - amp_min) * random();
+                if (!add(pos, amp, decay, 200.0f, true))
+                    return false;
+                pos                += lsp_max(gap, size_t(period * 2.0f * random()));
+            }
+
+            return true;
+        }
+
+        bool DrumPattern::render(size_t length, float noise)
+        {
+            float *data     = static_cast<float *>(realloc(vData, length * sizeof(float)));
+            if (data == NULL)
+                return false;
+            vData           = data;
+            nLength         = length;
+
+            // White noise
+            for (size_t i=0; i<length; ++i)
+                data[i]         = noise * (2.0f * random() - 1.0f);
+
+            // Hits, each hit is rendered until it decays below -120 dB
+            for (size_t i=0, n=vHits.size(); i<n; ++i)
+            {
+                const drum_hit_t *h = vHits.uget(i);
+                const float k       = expf(-1000.0f / (h->fDecay * nSampleRate));
+                const size_t half   = lsp_max(size_t(nSampleRate / (2.0f * h->fFreq)), size_t(1));
+                const size_t count  = lsp_min(size_t(h->fDecay * 0.001f * nSampleRate * 14.0f), length - lsp_min(h->nOnset, length));
+
+                float env           = h->fAmp;
+                float *dst          = &data[h->nOnset];
+                for (size_t j=0; j<count; ++j)
+                {
+                    dst[j]             += ((j / half) & 1) ? -env : env;
+                    env                *= k;
+                }
+            }
+
+            return true;
+        }
+
+        void DrumPattern::clear()
+        {
+            vHits.flush();
+            if (vData != NULL)
+            {
+                free(vData);
+                vData           = NULL;
+            }
+            nLength         = 0;
+        }
+
+    } /* namespace test */
+} /* namespace lsp */
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TEST_HELPERS_DRUM_PATTERN_H_
+#define TEST_HELPERS_DRUM_PATTERN_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/lltl/darray.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        /**
+         * Synthetic drum hit: a square tone with an exponentially decaying envelope.
+         * The absolute value of the tone is equal to the envelope, so the peak level
+         * of the hit at any moment is known exactly.
+         */
+        typedef struct drum_hit_t
+        {
+            size_t              nOnset;         // Position of the onset in samples
+            float               fAmp;           // Peak amplitude
+            float               fDecay;         // Time constant of the decay [ms]
+            float               fFreq;          // Frequency of the tone [Hz]
+            bool                bTarget;        // The hit should be detected, bleed otherwise
+        } drum_hit_t;
+
+        /**
+         * Generator of synthetic drum tracks with known onsets
+         */
+        class DrumPattern
+        {
+            protected:
+                lltl::darray<drum_hit_t>    vHits;          // List of hits
+                float                      *vData;          // Rendered signal
+                size_t                      nLength;        // Length of the rendered signal
+                size_t                      nSampleRate;    // Sample rate
+                uint32_t                    nSeed;          // State of the random generator
+
+            public:
+                explicit DrumPattern(size_t sample_rate, uint32_t seed = 0x1234567);
+                DrumPattern(const DrumPattern &) = delete;
+                DrumPattern(DrumPattern &&) = delete;
+                ~DrumPattern();
+
+                DrumPattern & operator = (const DrumPattern &) = delete;
+                DrumPattern & operator = (DrumPattern &&) = delete;
+
+            public:
+                /**
+                 * Get the next pseudo-random value
+                 * @return value in range [0, 1)
+                 */
+                float                       random();
+
+                /**
+                 * Add the hit to the pattern
+                 * @param onset position of the onset in samples
+                 * @param amp peak amplitude
+                 * @param decay time constant of the decay [ms]
+                 * @param freq frequency of the tone [Hz]
+                 * @param target the hit should be detected
+                 * @return true on success
+                 */
+                bool                        add(size_t onset, float amp, float decay, float freq, bool target);
+
+                /**
+                 * Add hits at pseudo-random positions with the average density
+                 * @param length length of the pattern in samples
+                 * @param density average number of hits per second
+                 * @param amp_min minimum amplitude
+                 * @param amp_max maximum amplitude
+                 * @param decay time constant of the decay [ms]
+                 * @return true on success
+                 */
+                bool                        add_random(size_t length, float density, float amp_min, float amp_max, float decay);
+
+                /**
+                 * Render the pattern
+                 * @param length length of the signal in samples
+                 * @param noise amplitude of the white noise added to the signal
+                 * @return true on success
+                 */
+                bool                        render(size_t length, float noise);
+
+                /**
+                 * Remove all hits and the rendered data
+                 */
+                void                        clear();
+
+            public:
+                inline const float         *data() const            { return vData;                 }
+                inline size_t               length() const          { return nLength;               }
+                inline size_t               sample_rate() const     { return nSampleRate;           }
+                inline size_t               hits() const            { return vHits.size();          }
+                inline const drum_hit_t    *hit(size_t index) const { return vHits.get(index);      }
+        };
+
+    } /* namespace test */
+} /* namespace lsp */
+
+#endif /* TEST_HELPERS_DRUM_PATTERN_H_ */
@@ -0,0 +1,475 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/plug-fw/meta/func.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/meta/trigger.h>
+
+#include "trigger_host.h"
+
+namespace lsp
+{
+    namespace test
+    {
+        //---------------------------------------------------------------------
+        // Ports
+        class TriggerHost::Port: public plug::IPort
+        {
+            protected:
+                LSPString           sID;
+                float               fValue;
+
+            public:
+                explicit Port(const meta::port_t *meta, const char *postfix): plug::IPort(meta)
+                {
+                    sID.set_utf8(meta->id);
+                    if (postfix != NULL)
+                        sID.append_utf8(postfix);
+                    fValue      = meta->start;
+                }
+
+            public:
+                inline const char  *id() const          { return sID.get_utf8(); }
+
+            public:
+                virtual float       value() override    { return fValue;    }
+                virtual void        set_value(float value) override { fValue = value; }
+        };
+
+        class TriggerHost::AudioPort: public TriggerHost::Port
+        {
+            protected:
+                float              *pBuffer;
+
+            public:
+                explicit AudioPort(const meta::port_t *meta, const char *postfix): Port(meta, postfix)
+                {
+                    pBuffer     = NULL;
+                }
+
+            public:
+                inline void         bind(float *buf)    { pBuffer = buf;    }
+
+            public:
+                virtual void       *buffer() override   { return pBuffer;   }
+        };
+
+        class TriggerHost::MidiPort: public TriggerHost::Port
+        {
+            protected:
+                plug::midi_t        sMidi;
+
+            public:
+                explicit MidiPort(const meta::port_t *meta, const char *postfix): Port(meta, postfix)
+                {
+                    sMidi.clear();
+                }
+
+            public:
+                inline plug::midi_t *midi()             { return &sMidi;    }
+
+            public:
+                virtual void       *buffer() override   { return &sMidi;    }
+        };
+
+        class TriggerHost::MeshPort: public TriggerHost::Port
+        {
+            protected:
+                plug::mesh_t       *pMesh;
+                uint8_t            *pData;
+
+            public:
+                explicit MeshPort(const meta::port_t *meta, const char *postfix): Port(meta, postfix)
+                {
+                    pMesh       = NULL;
+                    pData       = NULL;
+
+                    // Mesh metadata: start is the number of buffers, step is the number of items
+                    const size_t buffers    = size_t(meta->start);
+                    const size_t items      = size_t(meta->step);
+                    const size_t szof_mesh  = align_size(sizeof(plug::mesh_t) + buffers * sizeof(float *), DEFAULT_ALIGN);
+                    const size_t szof_buf   = align_size(items * sizeof(float), DEFAULT_ALIGN);
+
+                    uint8_t *ptr            = alloc_aligned<uint8_t>(pData, szof_mesh + szof_buf * buffers);
+                    if (ptr == NULL)
+                        return;
+                    bzero(ptr, szof_mesh + szof_buf * buffers);
+
+                    pMesh                   = advance_ptr_bytes<plug::mesh_t>(ptr, szof_mesh);
+                    for (size_t i=0; i<buffers; ++i)
+                        pMesh->pvData[i]        = advance_ptr_bytes<float>(ptr, szof_buf);
+                    pMesh->cleanup();
+                }
+
+                virtual ~MeshPort() override
+                {
+                    pMesh       = NULL;
+                    free_aligned(pData);
+                }
+
+            public:
+                inline void         consume()
+                {
+                    if ((pMesh != NULL) && (pMesh->containsData()))
+                        pMesh->cleanup();
+                }
+
+            public:
+                virtual void       *buffer() override   { return pMesh;     }
+        };
+
+        class TriggerHost::PathPort: public TriggerHost::Port
+        {
+            protected:
+                class Path: public plug::path_t
+                {
+                    public:
+                        char                sPath[PATH_MAX];
+                        char                sRequest[PATH_MAX];
+                        bool                bPending;
+                        bool                bAccepted;
+
+                    public:
+                        Path()
+                        {
+                            sPath[0]        = '\0';
+                            sRequest[0]     = '\0';
+                            bPending        = false;
+                            bAccepted       = false;
+                        }
+
+                    public:
+                        virtual const char *path() const override   { return sPath;     }
+                        virtual size_t      flags() const override  { return 0;         }
+                        virtual bool        pending() override      { return bPending;  }
+                        virtual bool        accepted() override     { return bAccepted; }
+
+                        virtual void        accept() override
+                        {
+                            strcpy(sPath, sRequest);
+                            bPending        = false;
+                            bAccepted       = true;
+                        }
+
+                        virtual void        commit() override
+                        {
+                            bAccepted       = false;
+                        }
+                };
+
+            protected:
+                Path                sPath;
+
+            public:
+                explicit PathPort(const meta::port_t *meta, const char *postfix): Port(meta, postfix)
+                {
+                }
+
+            public:
+                inline void         submit(const char *path)
+                {
+                    strncpy(sPath.sRequest, path, PATH_MAX - 1);
+                    sPath.sRequest[PATH_MAX - 1]    = '\0';
+                    sPath.bPending                  = true;
+                }
+
+            public:
+                virtual void       *buffer() override   { return &sPath;    }
+        };
+
+        //---------------------------------------------------------------------
+        // Host
+        TriggerHost::TriggerHost(const meta::plugin_t *meta):
+            plug::IWrapper(create_module(meta), NULL)
+        {
+            pMidiIn         = NULL;
+            pMidiOut        = NULL;
+            nPosition       = 0;
+            nSampleRate     = 0;
+            bDirty          = true;
+        }
+
+        TriggerHost::~TriggerHost()
+        {
+            destroy();
+        }
+
+        plug::Module *TriggerHost::create_module(const meta::plugin_t *meta)
+        {
+            for (plug::Factory *f = plug::Factory::root(); f != NULL; f = f->next())
+            {
+                for (size_t i=0; ; ++i)
+                {
+                    const meta::plugin_t *m = f->enumerate(i);
+                    if (m == NULL)
+                        break;
+                    if (m == meta)
+                        return f->create(m);
+                }
+            }
+
+            return NULL;
+        }
+
+        status_t TriggerHost::create_ports(const meta::port_t *meta, const char *postfix)
+        {
+            for ( ; meta->id != NULL; ++meta)
+            {
+                Port *p = NULL;
+
+                if (meta::is_audio_port(meta))
+                {
+                    AudioPort *ap   = new AudioPort(meta, postfix);
+                    if ((ap == NULL) || (!(meta::is_in_port(meta) ? vAudioIn.add(ap) : vAudioOut.add(ap))))
+                        return STATUS_NO_MEM;
+                    p               = ap;
+                }
+                else if (meta::is_midi_port(meta))
+                {
+                    MidiPort *mp    = new MidiPort(meta, postfix);
+                    if (mp == NULL)
+                        return STATUS_NO_MEM;
+                    if (meta::is_in_port(meta))
+                        pMidiIn         = mp;
+                    else
+                        pMidiOut        = mp;
+                    p               = mp;
+                }
+                else if (meta::is_mesh_port(meta))
+                {
+                    MeshPort *mp    = new MeshPort(meta, postfix);
+                    if ((mp == NULL) || (!vMeshes.add(mp)))
+                        return STATUS_NO_MEM;
+                    p               = mp;
+                }
+                else if (meta::is_path_port(meta))
+                    p               = new PathPort(meta, postfix);
+                else
+                    p               = new Port(meta, postfix);
+
+                if ((p == NULL) || (!vPorts.add(p)))
+                    return STATUS_NO_MEM;
+
+                // Port sets are flattened the same way as wrappers do: the selector goes
+                // first, then the members of each row with the row number postfix
+                if (!meta::is_port_set_port(meta))
+                    continue;
+
+                for (size_t row=0, rows=meta::list_size(meta->items); row < rows; ++row)
+                {
+                    char row_postfix[32];
+                    snprintf(row_postfix, sizeof(row_postfix), "%s_%d", (postfix != NULL) ? postfix : "", int(row));
+
+                    status_t res = create_ports(meta->members, row_postfix);
+                    if (res != STATUS_OK)
+                        return res;
+                }
+            }
+
+            return STATUS_OK;
+        }
+
+        void TriggerHost::destroy_ports()
+        {
+            for (size_t i=0, n=vPorts.size(); i<n; ++i)
+            {
+                Port *p = vPorts.uget(i);
+                if (p != NULL)
+                    delete p;
+            }
+            vPorts.flush();
+            vAudioIn.flush();
+            vAudioOut.flush();
+            vMeshes.flush();
+            vMidiEvents.flush();
+            pMidiIn         = NULL;
+            pMidiOut        = NULL;
+        }
+
+        status_t TriggerHost::init(size_t sample_rate)
+        {
+            if (pPlugin == NULL)
+                return STATUS_NOT_FOUND;
+
+            status_t res = sExecutor.start();
+            if (res != STATUS_OK)
+                return res;
+
+            if ((res = create_ports(pPlugin->metadata()->ports, NULL)) != STATUS_OK)
+                return res;
+
+            pPlugin->init(this, reinterpret_cast<plug::IPort **>(vPorts.array()));
+            pPlugin->set_sample_rate(sample_rate);
+            pPlugin->activate();
+
+            nSampleRate     = sample_rate;
+            nPosition       = 0;
+            bDirty          = true;
+
+            return STATUS_OK;
+        }
+
+        void TriggerHost::destroy()
+        {
+            if (pPlugin != NULL)
+            {
+                pPlugin->deactivate();
+                pPlugin->destroy();
+                delete pPlugin;
+                pPlugin         = NULL;
+
+                sExecutor.shutdown();
+            }
+
+            destroy_ports();
+        }
+
+        ipc::IExecutor *TriggerHost::executor()
+        {
+            return &sExecutor;
+        }
+
+        void TriggerHost::query_display_draw()
+        {
+        }
+
+        plug::IPort *TriggerHost::port(const char *id)
+        {
+            for (size_t i=0, n=vPorts.size(); i<n; ++i)
+            {
+                Port *p = vPorts.uget(i);
+                if (strcmp(p->id(), id) == 0)
+                    return p;
+            }
+            return NULL;
+        }
+
+        bool TriggerHost::set(const char *id, float value)
+        {
+            plug::IPort *p  = port(id);
+            if (p == NULL)
+                return false;
+
+            p->set_value(value);
+            bDirty          = true;
+            return true;
+        }
+
+        float TriggerHost::get(const char *id)
+        {
+            plug::IPort *p  = port(id);
+            return (p != NULL) ? p->value() : 0.0f;
+        }
+
+        bool TriggerHost::set_path(const char *id, const char *path)
+        {
+            plug::IPort *p  = port(id);
+            if ((p == NULL) || (!meta::is_path_port(p->metadata())))
+                return false;
+
+            static_cast<PathPort *>(p)->submit(path);
+            bDirty          = true;
+            return true;
+        }
+
+        void TriggerHost::process(float * const *outs, const float * const *ins, size_t samples)
+        {
+            if (bDirty)
+            {
+                pPlugin->update_settings();
+                bDirty          = false;
+            }
+
+            for (size_t i=0, n=vAudioIn.size(); i<n; ++i)
+                vAudioIn.uget(i)->bind(const_cast<float *>(ins[i]));
+            for (size_t i=0, n=vAudioOut.size(); i<n; ++i)
+                vAudioOut.uget(i)->bind((outs != NULL) ? outs[i] : NULL);
+            if (pMidiIn != NULL)
+                pMidiIn->midi()->clear();
+            if (pMidiOut != NULL)
+                pMidiOut->midi()->clear();
+
+            pPlugin->process(samples);
+
+            // Collect MIDI events with absolute timestamps
+            if (pMidiOut != NULL)
+            {
+                const plug::midi_t *midi = pMidiOut->midi();
+                for (size_t i=0; i<midi->nEvents; ++i)
+                {
+                    midi::event_t ev    = midi->vEvents[i];
+                    ev.timestamp        = nPosition + ev.timestamp;
+                    if (!vMidiEvents.add(&ev))
+                        break;
+                }
+            }
+
+            // Consume meshes like the UI does
+            for (size_t i=0, n=vMeshes.size(); i<n; ++i)
+                vMeshes.uget(i)->consume();
+
+            nPosition      += samples;
+        }
+
+        status_t TriggerHost::wait_status(const char *id, float seconds)
+        {
+            const size_t block  = 512;
+            const size_t settle = nSampleRate / 10;
+            float *buf          = static_cast<float *>(malloc(block * 2 * sizeof(float)));
+            if (buf == NULL)
+                return STATUS_NO_MEM;
+            dsp::fill_zero(buf, block * 2);
+
+            const float *ins[meta::trigger_metadata::TRACKS_MAX];
+            float *outs[meta::trigger_metadata::TRACKS_MAX];
+            for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX; ++i)
+            {
+                ins[i]              = buf;
+                outs[i]             = &buf[block];
+            }
+
+            // The status should stay the same for a while: the load may be followed by the render
+            status_t res        = STATUS_LOADING;
+            size_t stable       = 0;
+            for (size_t left = seconds * nSampleRate; left > 0; left -= lsp_min(left, block))
+            {
+                process(outs, ins, block);
+                const status_t code = status_t(get(id));
+                stable              = (code == res) ? stable + block : 0;
+                res                 = code;
+
+                if ((res != STATUS_LOADING) && (res != STATUS_IN_PROCESS) && (res != STATUS_UNSPECIFIED) && (stable >= settle))
+                    break;
+                ipc::Thread::sleep(1);
+            }
+
+            free(buf);
+            return res;
+        }
+
+    } /* namespace test */
+} /* namespace lsp */
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TEST_HELPERS_TRIGGER_HOST_H_
+#define TEST_HELPERS_TRIGGER_HOST_H_
+
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <lsp-plug.in/ipc/NativeExecutor.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/protocol/midi.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        /**
+         * Stand-in host for running the trigger plugin offline: instantiates the plugin,
+         * provides ports, the wrapper and the executor and drives the processing by blocks.
+         * Meshes are consumed after each block like the UI does, MIDI output is collected
+         * with absolute timestamps.
+         */
+        class TriggerHost: public plug::IWrapper
+        {
+            protected:
+                class Port;
+                class AudioPort;
+                class MidiPort;
+                class MeshPort;
+                class PathPort;
+
+            protected:
+                ipc::NativeExecutor         sExecutor;          // Executor for background tasks
+                lltl::parray<Port>          vPorts;             // All ports in the binding order
+                lltl::parray<AudioPort>     vAudioIn;           // Audio inputs
+                lltl::parray<AudioPort>     vAudioOut;          // Audio outputs
+                lltl::parray<MeshPort>      vMeshes;            // Mesh ports
+                MidiPort                   *pMidiIn;            // MIDI input
+                MidiPort                   *pMidiOut;           // MIDI output
+                lltl::darray<midi::event_t> vMidiEvents;        // Collected MIDI events, absolute timestamps
+                wsize_t                     nPosition;          // Number of processed samples
+                size_t                      nSampleRate;        // Sample rate
+                bool                        bDirty;             // Settings have been changed
+
+            protected:
+                static plug::Module        *create_module(const meta::plugin_t *meta);
+                status_t                    create_ports(const meta::port_t *meta, const char *postfix);
+                void                        destroy_ports();
+
+            public:
+                explicit TriggerHost(const meta::plugin_t *meta);
+                TriggerHost(const TriggerHost &) = delete;
+                TriggerHost(TriggerHost &&) = delete;
+                virtual ~TriggerHost() override;
+
+                TriggerHost & operator = (const TriggerHost &) = delete;
+                TriggerHost & operator = (TriggerHost &&) = delete;
+
+            public:
+                /**
+                 * Instantiate the plugin
+                 * @param sample_rate sample rate
+                 * @return status of operation
+                 */
+                status_t                    init(size_t sample_rate);
+
+                /**
+                 * Destroy the plugin and free all resources
+                 */
+                void                        destroy();
+
+            public: // plug::IWrapper
+                virtual ipc::IExecutor     *executor() override;
+                virtual void                query_display_draw() override;
+
+            public:
+                inline size_t               sample_rate() const     { return nSampleRate;           }
+                inline size_t               inputs() const          { return vAudioIn.size();       }
+                inline size_t               outputs() const         { return vAudioOut.size();      }
+                inline wsize_t              position() const        { return nPosition;             }
+                inline plug::Module        *module()                { return pPlugin;               }
+
+                /**
+                 * Get the port by identifier, members of port sets have the row number postfix: "sf_0"
+                 * @param id port identifier
+                 * @return port or NULL if not found
+                 */
+                plug::IPort                *port(const char *id);
+
+                /**
+                 * Set value of the control port, settings are applied before the next block
+                 * @param id port identifier
+                 * @param value value to set
+                 * @return true if port has been found
+                 */
+                bool                        set(const char *id, float value);
+
+                /**
+                 * Get value of the port
+                 * @param id port identifier
+                 * @return value of the port or 0 if port does not exist
+                 */
+                float                       get(const char *id);
+
+                /**
+                 * Submit the path to the path port
+                 * @param id port identifier
+                 * @param path path to submit
+                 * @return true if port has been found
+                 */
+                bool                        set_path(const char *id, const char *path);
+
+                /**
+                 * Process the block of audio data, the block may be of any size
+                 * @param outs output buffers, may be NULL for non-needed outputs
+                 * @param ins input buffers
+                 * @param samples number of samples to process
+                 */
+                void                        process(float * const *outs, const float * const *ins, size_t samples);
+
+                /**
+                 * Process silence until the status port reports the completion or the time is out
+                 * @param id identifier of the status port
+                 * @param seconds maximum time to wait, in seconds of processed audio
+                 * @return status reported by the port
+                 */
+                status_t                    wait_status(const char *id, float seconds);
+
+                /**
+                 * Get MIDI events emitted by the plugin since the last clear_midi()
+                 * @return MIDI events with absolute timestamps in samples
+                 */
+                inline const lltl::darray<midi::event_t> *midi_events() const { return &vMidiEvents; }
+
+                /**
+                 * Clear the collected MIDI events
+                 */
+                inline void                 clear_midi()            { vMidiEvents.clear();          }
+        };
+
+    } /* namespace test */
+} /* namespace lsp */
+
+#endif /* TEST_HELPERS_TRIGGER_HOST_H_ */
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/mm/InAudioFileStream.h>
+#include <lsp-plug.in/mm/OutAudioFileStream.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/meta/trigger.h>
+
+#include "../helpers/trigger_host.h"
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t BLOCK_SIZE      = 0x10000;  // Size of the processing block
+    static constexpr float  LOAD_TIMEOUT    = 60.0f;    // Timeout of the sample loading [s]
+    static constexpr float  EXPORT_TIMEOUT  = 10.0f;    // Timeout of the MIDI file export [s]
+
+    typedef struct options_t
+    {
+        const char     *sample;         // Sample file to trigger
+        float           detect;         // Detect level [dB], positive if not set
+        bool            midi;           // Export MIDI file
+        size_t          threads;        // Maximum number of threads
+    } options_t;
+
+    typedef struct job_t
+    {
+        const options_t    *options;    // Rendering options
+        const char * const *files;      // Input files
+        size_t              count;      // Number of input files
+        uatomic_t           next;       // Index of the next file to render
+        uatomic_t           failed;     // Number of failed files
+    } job_t;
+}
+
+MTEST_BEGIN("trigger", render)
+
+    static status_t render_file(const options_t *opt, const char *path)
+    {
+        // Open the source file, the file is processed by blocks and is never loaded entirely
+        mm::InAudioFileStream is;
+        status_t res            = is.open(path);
+        if (res != STATUS_OK)
+            return res;
+        lsp_finally { is.close(); };
+
+        mm::audio_stream_t info;
+        if ((res = is.info(&info)) != STATUS_OK)
+            return res;
+        if (info.channels <= 0)
+            return STATUS_UNSUPPORTED_FORMAT;
+
+        const size_t src_channels   = info.channels;
+        const size_t channels       = lsp_min(src_channels, meta::trigger_metadata::TRACKS_MAX);
+        const meta::plugin_t *meta  =
+            (opt->midi) ?
+                ((channels > 1) ? &meta::trigger_midi_stereo : &meta::trigger_midi_mono) :
+                ((channels > 1) ? &meta::trigger_stereo : &meta::trigger_mono);
+
+        // Open the output file with the same sample format
+        char out_path[PATH_MAX];
+        snprintf(out_path, sizeof(out_path), "%s-trigger.wav", path);
+
+        mm::audio_stream_t out_info = info;
+        out_info.channels       = channels;
+        mm::OutAudioFileStream os;
+        if ((res = os.open(out_path, &out_info, mm::AFMT_WAV | mm::CFMT_PCM)) != STATUS_OK)
+            return res;
+        lsp_finally { os.close(); };
+
+        // Allocate buffers: interleaved frames and separate channels
+        float *buf              = static_cast<float *>(malloc(sizeof(float) * BLOCK_SIZE * (src_channels + channels * 2)));
+        if (buf == NULL)
+            return STATUS_NO_MEM;
+        lsp_finally { free(buf); };
+
+        const float *ins[meta::trigger_metadata::TRACKS_MAX];
+        float *outs[meta::trigger_metadata::TRACKS_MAX];
+        float *vin[meta::trigger_metadata::TRACKS_MAX];
+        for (size_t i=0; i<channels; ++i)
+        {
+            vin[i]                  = &buf[BLOCK_SIZE * (src_channels + i)];
+            outs[i]                 = &buf[BLOCK_SIZE * (src_channels + channels + i)];
+            ins[i]                  = vin[i];
+        }
+
+        // Instantiate the trigger
+        test::TriggerHost host(meta);
+        if ((res = host.init(info.srate)) != STATUS_OK)
+            return res;
+
+        if (opt->detect <= 0.0f)
+            host.set("dl", dspu::db_to_gain(opt->detect));
+        if (opt->sample != NULL)
+        {
+            host.set_path("sf_0", opt->sample);
+            if ((res = host.wait_status("fs_0", LOAD_TIMEOUT)) != STATUS_OK)
+                return res;
+        }
+        if (opt->midi)
+            host.set("mrec", 1.0f);
+
+        // Render the file
+        while (true)
+        {
+            const ssize_t read      = is.read(buf, BLOCK_SIZE);
+            if (read < 0)
+            {
+                if (read == -STATUS_EOF)
+                    break;
+                return status_t(-read);
+            }
+            else if (read == 0)
+                break;
+
+            for (size_t i=0; i<channels; ++i)
+            {
+                const float *sptr       = &buf[i];
+                for (ssize_t j=0; j<read; ++j, sptr += src_channels)
+                    vin[i][j]               = *sptr;
+            }
+
+            host.process(outs, ins, read);
+
+            for (size_t i=0; i<channels; ++i)
+            {
+                float *dptr             = &buf[i];
+                for (ssize_t j=0; j<read; ++j, dptr += channels)
+                    *dptr                   = outs[i][j];
+            }
+
+            const ssize_t written   = os.write(buf, read);
+            if (written < 0)
+                return status_t(-written);
+        }
+
+        // Export recorded MIDI events
+        if (opt->midi)
+        {
+            snprintf(out_path, sizeof(out_path), "%s-trigger.mid", path);
+            host.set_path("mexf", out_path);
+            if ((res = host.wait_status("mexs", EXPORT_TIMEOUT)) != STATUS_OK)
+                return res;
+        }
+
+        return STATUS_OK;
+    }
+
+    static status_t worker(void *arg)
+    {
+        job_t *job              = static_cast<job_t *>(arg);
+
+        for (size_t index = atomic_add(&job->next, 1); index < job->count; index = atomic_add(&job->next, 1))
+        {
+            const char *path        = job->files[index];
+            const status_t res      = render_file(job->options, path);
+            if (res != STATUS_OK)
+                atomic_add(&job->failed, 1);
+            printf("%s: %s\n", path, get_status(res));
+        }
+
+        return STATUS_OK;
+    }
+
+    MTEST_MAIN
+    {
+        options_t opt;
+        opt.sample          = NULL;
+        opt.detect          = 1.0f;
+        opt.midi            = false;
+        opt.threads         = ipc::Thread::system_cores();
+
+        // Parse options, the remaining arguments are input files
+        int first           = 0;
+        for ( ; first < argc; ++first)
+        {
+            const char *arg     = argv[first];
+            if ((!strcmp(arg, "-s")) && (first + 1 < argc))
+                opt.sample          = argv[++first];
+            else if ((!strcmp(arg, "-d")) && (first + 1 < argc))
+                opt.detect          = atof(argv[++first]);
+            else if ((!strcmp(arg, "-j")) && (first + 1 < argc))
+                opt.threads         = lsp_max(atoi(argv[++first]), 1);
+            else if (!strcmp(arg, "-m"))
+                opt.midi            = true;
+            else
+                break;
+        }
+
+        if (first >= argc)
+        {
+            printf("Usage: trigger.render [-s sample_file] [-d detect_level_db] [-m] [-j threads] file...\n");
+            printf("  Outputs are written to <file>-trigger.wav and <file>-trigger.mid (with -m)\n");
+            return;
+        }
+
+        // Render files in parallel, the current thread also takes part in rendering
+        job_t job;
+        job.options         = &opt;
+        job.files           = &argv[first];
+        job.count           = argc - first;
+        job.next            = 0;
+        job.failed          = 0;
+
+        lltl::parray<ipc::Thread> threads;
+        for (size_t i=1, n=lsp_min(opt.threads, job.count); i<n; ++i)
+        {
+            ipc::Thread *t      = new ipc::Thread(worker, &job);
+            MTEST_ASSERT(t != NULL);
+            MTEST_ASSERT(t->start() == STATUS_OK);
+            MTEST_ASSERT(threads.add(t));
+        }
+
+        worker(&job);
+
+        for (size_t i=0, n=threads.size(); i<n; ++i)
+        {
+            ipc::Thread *t      = threads.uget(i);
+            t->join();
+            delete t;
+        }
+        threads.flush();
+
+        MTEST_ASSERT_MSG(job.failed == 0, "%d files have not been rendered", int(job.failed));
+    }
+
+MTEST_END
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+#include <private/meta/trigger.h>
+#include <private/plugins/trigger_profiler.h>
+
+#include "../helpers/drum_pattern.h"
+#include "../helpers/trigger_host.h"
+
+namespace
+{
+    using namespace lsp;
+
+    static const meta::plugin_t *variants[] =
+    {
+        &meta::trigger_mono,
+        &meta::trigger_stereo,
+        &meta::trigger_midi_mono,
+        &meta::trigger_midi_stereo,
+        NULL
+    };
+
+    static const size_t sample_rates[]  = { 44100, 48000, 96000, 0 };
+    static const size_t block_sizes[]   = { 32, 256, 1024, 8192, 0 };
+    static const float densities[]      = { 1.0f, 4.0f, 16.0f, 0.0f };
+
+    static const char *stage_ports[]    = { "ldsc", "lddt", "ldhk", "ldvc", "ldout" };
+
+    static constexpr float PATTERN_TIME = 4.0f;     // Length of the pattern [s]
+    static constexpr float SAMPLE_TIME  = 0.3f;     // Length of the triggered sample [s]
+}
+
+PTEST_BEGIN("trigger", throughput, 2, 100)
+
+    bool make_sample(const char *path, size_t sample_rate)
+    {
+        dspu::Sample s;
+        const size_t length = SAMPLE_TIME * sample_rate;
+        if (!s.init(1, length, length))
+            return false;
+        s.set_sample_rate(sample_rate);
+
+        test::DrumPattern p(sample_rate, 0x7654321);
+        float *dst          = s.channel(0);
+        for (size_t i=0; i<length; ++i)
+            dst[i]              = (2.0f * p.random() - 1.0f) * expf(-5.0f * i / length);
+
+        return s.save(path) >= 0;
+    }
+
+    bool call(const meta::plugin_t *meta, size_t sample_rate, size_t block, float density, const char *sample)
+    {
+        // Prepare the pattern
+        test::DrumPattern p(sample_rate);
+        const size_t length = PATTERN_TIME * sample_rate;
+        if ((!p.add_random(length, density, 0.25f, 1.0f, 30.0f)) || (!p.render(length, GAIN_AMP_M_60_DB)))
+            return false;
+
+        float *out          = static_cast<float *>(malloc(length * sizeof(float) * meta::trigger_metadata::TRACKS_MAX));
+        if (out == NULL)
+            return false;
+        lsp_finally { free(out); };
+
+        const float *ins[meta::trigger_metadata::TRACKS_MAX];
+        float *outs[meta::trigger_metadata::TRACKS_MAX];
+
+        // Instantiate the plugin and load the sample
+        test::TriggerHost host(meta);
+        if (host.init(sample_rate) != STATUS_OK)
+            return false;
+        host.set("dl", GAIN_AMP_M_18_DB);
+        host.set("prof", 1.0f);
+        if ((!host.set_path("sf_0", sample)) || (host.wait_status("fs_0", 10.0f) != STATUS_OK))
+            return false;
+
+        // Run the benchmark
+        char label[256];
+        snprintf(label, sizeof(label), "%s sr=%d block=%d density=%.1f",
+            meta->uid, int(sample_rate), int(block), density);
+        printf("Testing %s...\n", label);
+
+        float load[lsp::plugins::TriggerProfiler::ST_TOTAL];
+        size_t blocks       = 0;
+        wsize_t processed   = 0;
+        system::time_t start, end;
+
+        PTEST_LOOP(label,
+            for (size_t i=0; i<lsp::plugins::TriggerProfiler::ST_TOTAL; ++i)
+                load[i]             = 0.0f;
+            blocks              = 0;
+            processed           = 0;
+            system::get_time(&start);
+
+            for (size_t offset=0; offset < length; )
+            {
+                const size_t to_do  = lsp_min(length - offset, block);
+                for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX; ++i)
+                {
+                    ins[i]              = &p.data()[offset];
+                    outs[i]             = &out[i * length + offset];
+                }
+
+                host.process(outs, ins, to_do);
+                for (size_t i=0; i<lsp::plugins::TriggerProfiler::ST_TOTAL; ++i)
+                    load[i]            += host.get(stage_ports[i]);
+
+                offset             += to_do;
+                processed          += to_do;
+                ++blocks;
+            }
+
+            system::get_time(&end);
+        );
+
+        // Emit the machine-readable results of the last pass
+        const double time   = (end.seconds - start.seconds) + (double(end.nanos) - double(start.nanos)) * 1e-9;
+        printf("TRIGGER_BENCH variant=%s sr=%d block=%d density=%.1f samples_per_sec=%.0f",
+            meta->uid, int(sample_rate), int(block), density,
+            (time > 0.0) ? processed / time : 0.0);
+        for (size_t i=0; i<lsp::plugins::TriggerProfiler::ST_TOTAL; ++i)
+            printf(" %s=%.4f", stage_ports[i], (blocks > 0) ? load[i] / blocks : 0.0f);
+        printf("\n");
+
+        host.destroy();
+        return true;
+    }
+
+    PTEST_MAIN
+    {
+        for (const size_t *sr = sample_rates; *sr > 0; ++sr)
+        {
+            char sample[PATH_MAX];
+            snprintf(sample, sizeof(sample), "%s/ptest-trigger-%d.wav", tempdir(), int(*sr));
+            if (!make_sample(sample, *sr))
+            {
+                printf("Failed to create sample file %s\n", sample);
+                continue;
+            }
+
+            for (const meta::plugin_t * const *meta = variants; *meta != NULL; ++meta)
+                for (const size_t *block = block_sizes; *block > 0; ++block)
+                    for (const float *density = densities; *density > 0.0f; ++density)
+                    {
+                        if (!call(*meta, *sr, *block, *density, sample))
+                            printf("TRIGGER_BENCH variant=%s sr=%d block=%d density=%.1f status=failed\n",
+                                (*meta)->uid, int(*sr), int(*block), *density);
+                    }
+        }
+    }
+
+PTEST_END
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-trigger
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-trigger is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-trigger is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-trigger. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+#include <private/meta/trigger.h>
+
+#include "../helpers/drum_pattern.h"
+#include "../helpers/trigger_host.h"
+
+namespace
+{
+    using namespace lsp;
+
+    // Detector settings
+    static constexpr float DETECT_LEVEL     = 0.1f;     // Detect level [G]
+    static constexpr float DETECT_TIME      = 1.0f;     // Detect time [ms]
+    static constexpr float RELEASE_LEVEL    = 0.5f;     // Relative release level [G]
+    static constexpr float RELEASE_TIME     = 5.0f;     // Release time [ms]
+    static constexpr float DYNAMICS         = 100.0f;   // Dynamics [%]
+    static constexpr float DYNA_TOP         = 4.0f;     // Dynamics range 1 [G]
+    static constexpr float DYNA_BOTTOM      = 0.5f;     // Dynamics range 2 [G]
+    static constexpr float REACTIVITY       = 0.1f;     // Reactivity [ms]
+
+    static constexpr float PATTERN_TIME     = 4.0f;     // Length of the pattern [s]
+    static constexpr float MATCH_WINDOW     = 3.0f;     // Maximum latency above the detect time [ms]
+    static constexpr float JITTER_MAX       = 0.5f;     // Maximum deviation of the latency from the detect time [ms]
+
+    typedef struct scenario_t
+    {
+        const char     *name;
+        float           noise;          // Amplitude of the noise
+        float           velocity_error; // Maximum velocity error in MIDI units
+        bool            bleed;          // Add bleed between hits
+        bool            flams;          // Add flams
+    } scenario_t;
+
+    static const scenario_t scenarios[] =
+    {
+        { "clean",      0.0f,                   2.0f,   false,  false   },
+        { "bleed",      0.0f,                   2.0f,   true,   false   },
+        { "noise",      DETECT_LEVEL * 0.3f,    10.0f,  false,  false   },
+        { "flams",      0.0f,                   2.0f,   false,  true    },
+        { NULL,         0.0f,                   0.0f,   false,  false   }
+    };
+
+    static const meta::plugin_t *variants[] =
+    {
+        &meta::trigger_midi_mono,
+        &meta::trigger_midi_stereo,
+        NULL
+    };
+
+    static const size_t sample_rates[]  = { 48000, 96000, 0 };
+    static const size_t block_sizes[]   = { 1, 37, 256, 4096, 8192, 10000, 0 };
+
+    typedef struct stats_t
+    {
+        size_t          hits;           // Number of hits that should be detected
+        size_t          detected;       // Number of emitted Note On events
+        size_t          fp;             // Number of false positives
+        size_t          fn;             // Number of false negatives
+        float           latency;        // Mean latency [ms]
+        float           jitter;         // Maximum deviation of the latency from the detect time [ms]
+        float           vel_mean;       // Mean velocity error
+        float           vel_max;        // Maximum velocity error
+    } stats_t;
+}
+
+UTEST_BEGIN("trigger", onsets)
+
+    static float expected_velocity(float level)
+    {
+        // The same mapping as the detector applies to the level of the trigger function
+        const float v   = 0.5f * expf(DYNAMICS * 0.01f * logf(level / DETECT_LEVEL));
+        float vel       =
+            (v >= DYNA_TOP) ? 1.0f :
+            (v <= DYNA_BOTTOM) ? 0.0f :
+            logf(v / DYNA_BOTTOM) / logf(DYNA_TOP / DYNA_BOTTOM);
+        return 1.0f + vel * 126.0f;
+    }
+
+    void build_pattern(test::DrumPattern *p, const scenario_t *s)
+    {
+        const size_t sr         = p->sample_rate();
+        const size_t length     = PATTERN_TIME * sr;
+        const size_t period     = (s->flams) ? sr / 4 : sr / 5;
+
+        for (size_t pos = sr / 10, i = 0; pos + period < length; pos += period, ++i)
+        {
+            // Spread the amplitudes over the whole dynamic range
+            const float amp         = 0.2f + 0.8f * ((i * 7) % 11) / 10.0f;
+
+            if (s->flams)
+            {
+                p->add(pos, 0.5f + 0.5f * amp, 3.0f, 200.0f, true);
+                p->add(pos + sr * 0.03f, amp, 3.0f, 200.0f, true);
+            }
+            else
+                p->add(pos, amp, 20.0f, 200.0f, true);
+
+            // Bleed of another drum below the detect level between the hits
+            if (s->bleed)
+                p->add(pos + period / 2, DETECT_LEVEL * 0.6f, 20.0f, 350.0f, false);
+        }
+    }
+
+    void run(stats_t *st, const meta::plugin_t *meta, size_t sample_rate, size_t block, const scenario_t *s)
+    {
+        test::DrumPattern p(sample_rate);
+        build_pattern(&p, s);
+        const size_t length     = PATTERN_TIME * sample_rate;
+        UTEST_ASSERT(p.render(length, s->noise));
+
+        float *out              = static_cast<float *>(malloc(block * sizeof(float) * meta::trigger_metadata::TRACKS_MAX));
+        UTEST_ASSERT(out != NULL);
+        lsp_finally { free(out); };
+
+        // Run the trigger
+        test::TriggerHost host(meta);
+        UTEST_ASSERT(host.init(sample_rate) == STATUS_OK);
+        host.set("mode", 0.0f);             // Peak
+        host.set("dl", DETECT_LEVEL);
+        host.set("dt", DETECT_TIME);
+        host.set("rrl", RELEASE_LEVEL);
+        host.set("rt", RELEASE_TIME);
+        host.set("dyna", DYNAMICS);
+        host.set("dtr1", DYNA_TOP);
+        host.set("dtr2", DYNA_BOTTOM);
+        host.set("react", REACTIVITY);
+
+        const float *ins[meta::trigger_metadata::TRACKS_MAX];
+        float *outs[meta::trigger_metadata::TRACKS_MAX];
+        for (size_t offset = 0; offset < length; )
+        {
+            const size_t to_do      = lsp_min(length - offset, block);
+            for (size_t i=0; i<meta::trigger_metadata::TRACKS_MAX; ++i)
+            {
+                ins[i]                  = &p.data()[offset];
+                outs[i]                 = &out[i * block];
+            }
+            host.process(outs, ins, to_do);
+            offset                 += to_do;
+        }
+
+        // Collect Note On events
+        const lltl::darray<midi::event_t> *events = host.midi_events();
+        lltl::darray<midi::event_t> notes;
+        for (size_t i=0, n=events->size(); i<n; ++i)
+        {
+            const midi::event_t *ev = events->uget(i);
+            if (ev->type == midi::MIDI_MSG_NOTE_ON)
+                UTEST_ASSERT(notes.add(ev));
+        }
+        host.destroy();
+
+        // Match the detected events with the ground truth
+        const float ms          = sample_rate * 0.001f;
+        const size_t window     = (DETECT_TIME + MATCH_WINDOW) * ms;
+        bool *used              = static_cast<bool *>(calloc(lsp_max(notes.size(), size_t(1)), sizeof(bool)));
+        UTEST_ASSERT(used != NULL);
+        lsp_finally { free(used); };
+
+        bzero(st, sizeof(stats_t));
+        st->detected            = notes.size();
+        size_t matched          = 0;
+        for (size_t i=0, n=p.hits(); i<n; ++i)
+        {
+            const test::drum_hit_t *h   = p.hit(i);
+            if (!h->bTarget)
+                continue;
+            ++st->hits;
+
+            ssize_t found           = -1;
+            for (size_t j=0, m=notes.size(); j<m; ++j)
+            {
+                const midi::event_t *ev = notes.uget(j);
+                if ((used[j]) || (ev->timestamp < h->nOnset) || (ev->timestamp > h->nOnset + window))
+                    continue;
+                found                   = j;
+                break;
+            }
+
+            if (found < 0)
+            {
+                ++st->fn;
+                continue;
+            }
+            used[found]             = true;
+            ++matched;
+
+            const midi::event_t *ev = notes.uget(found);
+            const float latency     = (ev->timestamp - h->nOnset) / ms;
+            const float level       = h->fAmp * expf(-DETECT_TIME / h->fDecay);
+            const float vel_error   = fabsf(ev->note.velocity - expected_velocity(level));
+
+            st->latency            += latency;
+            st->jitter              = lsp_max(st->jitter, fabsf(latency - DETECT_TIME));
+            st->vel_mean           += vel_error;
+            st->vel_max             = lsp_max(st->vel_max, vel_error);
+        }
+
+        st->fp                  = notes.size() - matched;
+        if (matched > 0)
+        {
+            st->latency            /= matched;
+            st->vel_mean           /= matched;
+        }
+    }
+
+    UTEST_MAIN
+    {
+        for (const meta::plugin_t * const *meta = variants; *meta != NULL; ++meta)
+            for (const size_t *sr = sample_rates; *sr > 0; ++sr)
+                for (const size_t *block = block_sizes; *block > 0; ++block)
+                    for (const scenario_t *s = scenarios; s->name != NULL; ++s)
+                    {
+                        stats_t st;
+                        run(&st, *meta, *sr, *block, s);
+
+                        printf("TRIGGER_ONSETS variant=%s sr=%d block=%d scenario=%s hits=%d detected=%d fp=%d fn=%d "
+                            "latency=%.3f jitter=%.3f vel_error_mean=%.2f vel_error_max=%.2f\n",
+                            (*meta)->uid, int(*sr), int(*block), s->name,
+                            int(st.hits), int(st.detected), int(st.fp), int(st.fn),
+                            st.latency, st.jitter, st.vel_mean, st.vel_max);
+
+                        UTEST_ASSERT_MSG(st.fn == 0, "%d hits have not been detected", int(st.fn));
+                        UTEST_ASSERT_MSG(st.fp == 0, "%d false hits have been detected", int(st.fp));
+                        UTEST_ASSERT_MSG(st.jitter <= JITTER_MAX, "latency deviates from the detect time by %.3f ms", st.jitter);
+                        UTEST_ASSERT_MSG(st.vel_max <= s->velocity_error, "velocity error %.2f is too high", st.vel_max);
+                    }
+    }
+
+UTEST_END